@@ -0,0 +1,108 @@
+#ifndef Batch_hxx
+    #define Batch_hxx
+
+    #include <algorithm>
+    #include <cstring>
+    #include <span>
+    #include <stdexcept>
+
+    #include "Expressions.hxx"
+
+    namespace femto
+    {
+        namespace batch
+        {
+            // number of doubles processed by one evaluation of the expression tree
+            #if defined(__AVX512F__)
+                inline constexpr std::size_t width = 8;
+            #elif defined(__AVX__)
+                inline constexpr std::size_t width = 4;
+            #else
+                inline constexpr std::size_t width = 2;
+            #endif
+
+            using Pack = double __attribute__((vector_size(width * sizeof(double))));
+
+            // argument holding one pack of values of the variable T, it is accepted by Variable<T> in place of T
+            template <typename T>
+            struct Lane
+            {
+                Pack value;
+                [[nodiscard]] constexpr Pack operator()() const {return value;}
+            };
+
+            template <typename T>
+            struct Input
+            {
+                using type = std::span<const double>;
+            };
+
+            namespace detail
+            {
+                [[nodiscard]] inline Pack load(std::span<const double> values, std::size_t pos) noexcept
+                {
+                    Pack pack;
+                    std::memcpy(&pack,values.data() + pos,sizeof(Pack));
+                    return pack;
+                }
+
+                // the remainder of the input is padded with its last value, so the spare lanes do not produce spurious nans or infs
+                [[nodiscard]] inline Pack load_partial(std::span<const double> values, std::size_t pos) noexcept
+                {
+                    Pack pack;
+                    for (std::size_t i = 0; i < width; ++i)
+                    {
+                        pack[i] = values[std::min(pos + i,values.size() - 1)];
+                    }
+                    return pack;
+                }
+
+                template <typename R>
+                inline void store(R result, std::span<double> out, std::size_t pos, std::size_t count) noexcept
+                {
+                    if constexpr (Packed<R>)
+                    {
+                        std::memcpy(out.data() + pos,&result,count * sizeof(double));
+                    }
+                    else // expression does not depend on any of the variables
+                    {
+                        std::fill_n(out.data() + pos,count,static_cast<double>(result));
+                    }
+                }
+            }
+        }
+
+        namespace detail
+        {
+            template <typename T>
+            struct VariableOf<batch::Lane<T> >
+            {
+                using type = T;
+            };
+        }
+
+        // Evaluates func at every point described by the input spans (one span per variable type, in the order of Vars) and writes the results to out, e.g.
+        // evaluate<X,Y>(f,out,xs,ys); is equivalent to out[i] = f(X{xs[i]},Y{ys[i]}); for every i
+        // Throws std::invalid_argument if an input span and out differ in size.
+        template <typename ... Vars, typename T>
+        void evaluate(const T &func, std::span<double> out, typename batch::Input<Vars>::type ... inputs)
+        {
+            if (((inputs.size() != out.size()) || ...))
+            {
+                throw std::invalid_argument("femto::evaluate: the input spans and the output span differ in size");
+            }
+
+            const std::size_t size = out.size();
+            const std::size_t bulk = size - size % batch::width;
+            for (std::size_t i = 0; i < bulk; i += batch::width)
+            {
+                batch::detail::store(func(batch::Lane<Vars>{batch::detail::load(inputs,i)}...),out,i,batch::width);
+            }
+            if (bulk < size)
+            {
+                batch::detail::store(func(batch::Lane<Vars>{batch::detail::load_partial(inputs,bulk)}...),out,bulk,size - bulk);
+            }
+        }
+    }
+
+#endif
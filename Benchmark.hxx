@@ -0,0 +1,37 @@
+#ifndef Benchmark_hxx
+    #define Benchmark_hxx
+
+    #include <algorithm>
+    #include <chrono>
+    #include <cstddef>
+    #include <limits>
+
+    namespace femto
+    {
+        namespace bench
+        {
+            // prevents the compiler from optimising away the computation of value
+            template <typename T>
+            inline void do_not_optimise(const T &value)
+            {
+                asm volatile("" : : "g"(&value) : "memory");
+            }
+
+            // returns the best (minimal) wall time of repetitions calls of func in nanoseconds
+            template <typename F>
+            [[nodiscard]] double measure_ns(F &&func, std::size_t repetitions = 5)
+            {
+                double best = std::numeric_limits<double>::max();
+                for (std::size_t i = 0; i < repetitions; ++i)
+                {
+                    const auto start = std::chrono::steady_clock::now();
+                    func();
+                    const auto stop = std::chrono::steady_clock::now();
+                    best = std::min(best,std::chrono::duration<double,std::nano>(stop - start).count());
+                }
+                return best;
+            }
+        }
+    }
+
+#endif
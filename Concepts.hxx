@@ -1,13 +1,45 @@
 #ifndef Concepts_hxx
     #define Concepts_hxx
 
+    #include <cstddef>
+    #include <type_traits>
+    #include <concepts>
+    #include <utility>
+
     namespace femto
     {
-        #include <type_traits>
-        #include <concepts>
+        template <std::size_t N>
+        class Jet;
+
+        namespace detail
+        {
+            template <typename T>
+            struct IsJet : std::false_type {};
+
+            template <std::size_t N>
+            struct IsJet<Jet<N> > : std::true_type {};
+        }
+
+        template <typename T>
+        concept Scalar = std::integral<std::remove_cvref_t<T> > || std::floating_point<std::remove_cvref_t<T> >;
+
+        // truncated Taylor series (see Jet.hxx)
+        template <typename T>
+        concept Taylor = detail::IsJet<std::remove_cvref_t<T> >::value;
+
+        // packed (SIMD) values, e.g. gcc vector extension types, which support element-wise arithmetic and lane access
+        template <typename T>
+        concept Packed = !Scalar<T> && !Taylor<T> && requires(std::remove_cvref_t<T> a, std::size_t i)
+        {
+            {a + a} -> std::same_as<std::remove_cvref_t<T> >;
+            {a - a} -> std::same_as<std::remove_cvref_t<T> >;
+            {a * a} -> std::same_as<std::remove_cvref_t<T> >;
+            {a / a} -> std::same_as<std::remove_cvref_t<T> >;
+            {a[i]} -> Scalar;
+        };
 
         template <typename T>
-        concept Arithmetic = std::integral<std::remove_cvref_t<T> > || std::floating_point<std::remove_cvref_t<T> >;
+        concept Arithmetic = Scalar<T> || Packed<T> || Taylor<T>;
 
         template <typename T, typename ... Args>
         concept Functionlike = std::invocable<T,Args...> && requires(T func, Args &&... args)
@@ -16,4 +48,4 @@
         };
     }
 
-#endif
\ No newline at end of file
+#endif
@@ -1,8 +1,8 @@
 #ifndef Constants_hxx
-    #define COnstants_hxx
+    #define Constants_hxx
 
     #include "Expressions.hxx"
-    #include <numeric>
+    #include <numbers>
 
     namespace femto
     {
@@ -10,9 +10,10 @@
         {
             inline constexpr Constant protonMassMeV(938.27208816);
             inline constexpr Constant fineStructure(0.007297);
+            inline constexpr Constant hbarcMeVfm(197.3269804);
             inline constexpr Constant piConst(std::numbers::pi);
             inline constexpr Function elementaryCharge = sqrt(Constant(4) * piConst * fineStructure);
         }
     }
 
-#endif
\ No newline at end of file
+#endif
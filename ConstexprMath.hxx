@@ -1,7 +1,16 @@
 #ifndef ConstexprMath_hxx
     #define ConstexprMath_hxx
 
+    #include <array>
+    #include <bit>
+    #include <cmath>
+    #include <cstdint>
     #include <limits>
+    #include <type_traits>
+    #include <utility>
+    #if defined(__SSE2__)
+        #include <immintrin.h>
+    #endif
     #include "Concepts.hxx"
 
 	namespace femto
@@ -77,6 +86,136 @@
 				return detail_power::power(t,make_index_sequence_of_same_value<1,N>());
 			}
 
+			// Runtime kernels: range reduction followed by a short minimax polynomial (fdlibm coefficients). They contain no branches,
+			// so the same code works for a double and for a pack of doubles, where every lane is computed in parallel.
+			namespace detail_fast
+			{
+				template <typename V>
+				struct Bits
+				{
+					using type = std::uint64_t;
+				};
+
+				template <Packed V>
+				struct Bits<V>
+				{
+					using type [[gnu::vector_size(sizeof(V))]] = std::uint64_t;
+				};
+
+				template <typename V>
+				[[nodiscard]] constexpr V splat(double val) noexcept
+				{
+					return V{} + val;
+				}
+
+				template <typename M, typename V>
+				[[nodiscard]] constexpr V select(M mask, V lhs, V rhs) noexcept
+				{
+					return mask ? lhs : rhs;
+				}
+
+				template <typename V>
+				[[nodiscard]] constexpr V exp(V x) noexcept
+				{
+					using U = typename Bits<V>::type;
+
+					constexpr double invLn2 = 1.44269504088896338700e+00;
+					constexpr double ln2Hi = 6.93147180369123816490e-01;
+					constexpr double ln2Lo = 1.90821492927058770002e-10;
+					constexpr double shift = 0x1.8p52; // x + shift rounds x to an integer, which is then stored in the low bits of the mantissa
+					constexpr double P1 = 1.66666666666666019037e-01;
+					constexpr double P2 = -2.77777777770155933842e-03;
+					constexpr double P3 = 6.61375632143793436117e-05;
+					constexpr double P4 = -1.65339022054652515390e-06;
+					constexpr double P5 = 4.13813679705723846039e-08;
+
+					// beyond these bounds the result is 0 or inf anyway, nans pass through
+					const V xc = select(x < -746.,splat<V>(-746.),select(x > 710.,splat<V>(710.),x));
+
+					// exp(x) = 2^k * exp(r), where k = round(x / ln2) and |r| <= ln2 / 2
+					const V kShifted = xc * invLn2 + shift;
+					const V k = kShifted - shift;
+					const V hi = xc - k * ln2Hi;
+					const V lo = k * ln2Lo;
+					const V r = hi - lo;
+					const V r2 = r * r;
+					const V c = r - r2 * (P1 + r2 * (P2 + r2 * (P3 + r2 * (P4 + r2 * P5))));
+					const V y = 1. - ((lo - (r * c) / (2. - c)) - hi);
+
+					// 2^k = 2^(e1 - 1023) * 2^(e2 - 1023), where e1 + e2 = k + 2046; both factors are normal numbers even if the result is subnormal or overflows
+					const U e = std::bit_cast<U>(kShifted) - std::bit_cast<std::uint64_t>(shift) + 2046;
+					const U e1 = e >> 1;
+					const U e2 = e - e1;
+					return y * std::bit_cast<V>(e1 << 52) * std::bit_cast<V>(e2 << 52);
+				}
+
+				template <typename V>
+				[[nodiscard]] constexpr V ln(V x) noexcept
+				{
+					using U = typename Bits<V>::type;
+
+					constexpr double ln2Hi = 6.93147180369123816490e-01;
+					constexpr double ln2Lo = 1.90821492927058770002e-10;
+					constexpr double Lg1 = 6.666666666666735130e-01;
+					constexpr double Lg2 = 3.999999999940941908e-01;
+					constexpr double Lg3 = 2.857142874366239149e-01;
+					constexpr double Lg4 = 2.222219843214978396e-01;
+					constexpr double Lg5 = 1.818357216161805012e-01;
+					constexpr double Lg6 = 1.531383769920937332e-01;
+					constexpr double Lg7 = 1.479819860511658591e-01;
+					constexpr double inf = std::numeric_limits<double>::infinity();
+
+					// subnormal numbers are scaled into the normal range first
+					const auto subnormal = x < 0x1p-1022;
+					U u = std::bit_cast<U>(select(subnormal,x * 0x1p54,x));
+
+					// x = 2^k * m, where sqrt(2)/2 < m < sqrt(2)
+					u = u + (std::uint64_t(0x3ff00000 - 0x3fe6a09e) << 32);
+					const V k = std::bit_cast<V>((u >> 52) | 0x4330000000000000) - (0x1p52 + 1023.) + select(subnormal,splat<V>(-54.),splat<V>(0.));
+					u = (u & 0x000fffffffffffff) + (std::uint64_t(0x3fe6a09e) << 32);
+
+					// ln(m) = ln(1 + f) = 2s + s * R(s^2), where s = f / (2 + f)
+					const V f = std::bit_cast<V>(u) - 1.;
+					const V hfsq = 0.5 * f * f;
+					const V s = f / (2. + f);
+					const V z = s * s;
+					const V w = z * z;
+					const V t1 = w * (Lg2 + w * (Lg4 + w * Lg6));
+					const V t2 = z * (Lg1 + w * (Lg3 + w * (Lg5 + w * Lg7)));
+					const V result = s * (hfsq + t1 + t2) + k * ln2Lo - hfsq + f + k * ln2Hi;
+
+					// ln(0) = -inf, ln(inf) = inf, ln(x < 0) = ln(nan) = nan
+					return select((x > 0.) & (x < inf),result,select(x == 0.,splat<V>(-inf),select(x == inf,splat<V>(inf),splat<V>(std::numeric_limits<double>::quiet_NaN()))));
+				}
+
+				// square root of every lane of a pack of doubles with the vector instruction of the target, nan for negative or infinite lanes
+				template <Packed V>
+				[[nodiscard]] inline V sqrt(V x) noexcept
+				{
+					constexpr double inf = std::numeric_limits<double>::infinity();
+					V root;
+					if constexpr (false) {}
+				#if defined(__AVX512F__)
+					else if constexpr (sizeof(V) == 64) {root = _mm512_mask_sqrt_pd(x,0xff,x);} // the masked form, as _mm512_sqrt_pd trips -Wuninitialized in gcc 12
+				#endif
+				#if defined(__AVX__)
+					else if constexpr (sizeof(V) == 32) {root = _mm256_sqrt_pd(x);}
+				#endif
+				#if defined(__SSE2__)
+					else if constexpr (sizeof(V) == 16) {root = _mm_sqrt_pd(x);}
+				#endif
+					else // no vector instruction for this width, the lanes are computed one by one
+					{
+						for (std::size_t i = 0; i < sizeof(V) / sizeof(double); ++i) {root[i] = std::sqrt(x[i]);}
+					}
+					return select((x >= 0.) & (x < inf),root,splat<V>(std::numeric_limits<double>::quiet_NaN()));
+				}
+
+				// types for which the runtime kernels are used, others always take the constexpr path
+				template <typename T>
+				inline constexpr bool supported = std::is_same_v<std::remove_cvref_t<T>,double> || std::is_same_v<std::remove_cvref_t<T>,float>;
+			}
+
 			// Exponential
 			namespace detail_exp
 			{
@@ -91,16 +230,30 @@
 				{
 					return (t > 0) ? T(1) + (exp_impl<Is + 1,T>(t) + ...) : T(1) / (T(1) + (exp_impl<Is + 1,T>(-t) + ...));
 				}
+
+				// Taylor series expansion, used in constant evaluation
+				template <Arithmetic T>
+				[[nodiscard]] constexpr T exp_series(T t) noexcept
+				{
+					return (t == 0) ? T(1) : 
+						(t == -std::numeric_limits<T>::infinity()) ? T(0) :
+						(t == std::numeric_limits<T>::infinity()) ? std::numeric_limits<T>::infinity() :
+						is_nan(t) ? std::numeric_limits<T>::quiet_NaN() :
+						exp(t, std::make_index_sequence<limits::Depth<T>::limit>{});
+				}
 			}
 
 			template <Arithmetic T>
 			[[nodiscard]] constexpr T exp(T t) noexcept
 			{
-				return (t == 0) ? T(1) : 
-					(t == -std::numeric_limits<T>::infinity()) ? T(0) :
-					(t == std::numeric_limits<T>::infinity()) ? std::numeric_limits<T>::infinity() :
-					is_nan(t) ? std::numeric_limits<T>::quiet_NaN() :
-					detail_exp::exp(t, std::make_index_sequence<limits::Depth<T>::limit>{});
+				if constexpr (detail_fast::supported<T>)
+				{
+					if (!std::is_constant_evaluated())
+					{
+						return static_cast<T>(detail_fast::exp(static_cast<double>(t)));
+					}
+				}
+				return detail_exp::exp_series(t);
 			}
 
 			// Square root
@@ -111,12 +264,25 @@
 				{
 					return curr == prev ? curr : sqrtNewtonRaphson<T>(x, 0.5 * (curr + x / curr), curr);
 				}
+
+				template <Arithmetic T>
+				[[nodiscard]] constexpr T sqrt_newton(T t) noexcept
+				{
+					return t >= 0 && t < std::numeric_limits<T>::infinity() ? sqrtNewtonRaphson<T>(t, t, T(0)) : std::numeric_limits<T>::quiet_NaN();
+				}
 			}
 
 			template <Arithmetic T>
 			[[nodiscard]] constexpr T sqrt(T t) noexcept
 			{
-				return t >= 0 && t < std::numeric_limits<T>::infinity() ? detail_sqrt::sqrtNewtonRaphson<T>(t, t, T(0)) : std::numeric_limits<T>::quiet_NaN();
+				if constexpr (detail_fast::supported<T>)
+				{
+					if (!std::is_constant_evaluated()) // hardware instruction
+					{
+						return t >= 0 && t < std::numeric_limits<T>::infinity() ? std::sqrt(t) : std::numeric_limits<T>::quiet_NaN();
+					}
+				}
+				return detail_sqrt::sqrt_newton(t);
 			}
 
 			//Natural logarithm
@@ -139,88 +305,187 @@
 				{
 					return (val < 1) ? -ln_impl_1(T(1) / val) : ln_impl_1(val);
 				}
+
+				// Taylor series expansion, used in constant evaluation
+				template <Arithmetic T>
+				[[nodiscard]] constexpr T ln_series(T t) noexcept
+				{
+					return is_nan(t) ? t
+						: t == 0 ? -std::numeric_limits<T>::infinity()
+						: t == std::numeric_limits<T>::infinity() ? std::numeric_limits<T>::infinity()
+						: t < 0 ? std::numeric_limits<T>::quiet_NaN()
+						: t == 1 ? T(0)
+						: ln_impl(t);
+				}
 			} // namespace detail_ln
 
 			template <Arithmetic T>
 			[[nodiscard]] constexpr T ln(T t) noexcept
 			{
-				return is_nan(t) ? t
-					: t == 0 ? -std::numeric_limits<T>::infinity()
-					: t == std::numeric_limits<T>::infinity() ? std::numeric_limits<T>::infinity()
-					: t < 0 ? std::numeric_limits<T>::quiet_NaN()
-					: t == 1 ? T(0)
-					: detail_ln::ln_impl(t);
+				if constexpr (detail_fast::supported<T>)
+				{
+					if (!std::is_constant_evaluated())
+					{
+						return static_cast<T>(detail_fast::ln(static_cast<double>(t)));
+					}
+				}
+				return detail_ln::ln_series(t);
 			}
 
 			// power with real exponent
-			template <Arithmetic T, Arithmetic U>
-			[[nodiscard]] consteval T pow(T base, U exponent) noexcept
+			namespace detail_pow
 			{
-				if constexpr (is_nan(base) || is_nan(exponent)) 
-				{
-					std::numeric_limits<T>::quiet_NaN();
-				}
-				else
+				// repeated squaring, exact up to rounding and much cheaper than exp(b * ln(a))
+				template <Arithmetic T>
+				[[nodiscard]] constexpr T pow_integral(T base, long long exponent) noexcept
 				{
-					if constexpr (base == -std::numeric_limits<T>::infinity())
+					T result = 1;
+					for (unsigned long long n = exponent < 0 ? -exponent : exponent; n > 0; n >>= 1)
 					{
-						return -std::numeric_limits<T>::infinity();
+						if (n & 1) {result *= base;}
+						base *= base;
 					}
-					else if constexpr (base == std::numeric_limits<T>::infinity())
+					return exponent < 0 ? T(1) / result : result;
+				}
+			}
+
+			// the result is floating-point even for integral operands, e.g. pow(2,0.5) or pow(2,-1)
+			template <Scalar T, Scalar U>
+			using pow_result_t = std::conditional_t<std::floating_point<T> || std::floating_point<U>,std::common_type_t<T,U>,double>;
+
+			template <Scalar T, Scalar U>
+			[[nodiscard]] constexpr pow_result_t<T,U> pow(T base, U exponent) noexcept
+			{
+				using F = pow_result_t<T,U>;
+				constexpr F inf = std::numeric_limits<F>::infinity();
+
+				// the special values follow C's pow: a^0 = 1 and 1^b = 1 even for nans
+				if (exponent == 0 || base == 1)
+				{
+					return F(1);
+				}
+				if (is_nan(base) || is_nan(exponent))
+				{
+					return std::numeric_limits<F>::quiet_NaN();
+				}
+
+				// exponents which are integers below 2^53 can be checked for parity
+				const bool isSmall = exponent > -0x1p53 && exponent < 0x1p53;
+				const bool isIntegral = !isSmall || static_cast<long long>(exponent) == exponent;
+				if (isSmall && isIntegral && exponent >= -64 && exponent <= 64)
+				{
+					return detail_pow::pow_integral<F>(base,static_cast<long long>(exponent));
+				}
+
+				const F absBase = static_cast<F>(base < 0 ? -base : base);
+				const F magnitude = (base == 0 || absBase == inf) ? ((exponent > 0) == (base != 0) ? inf : F(0))
+					: (exponent == inf || exponent == -inf) ? (absBase == 1 ? F(1) : (absBase < 1) == (exponent > 0) ? F(0) : inf) // (-1)^inf = 1
+					: exp(static_cast<F>(exponent) * ln(absBase));
+
+				if (std::signbit(base)) // negative bases including -0, whose odd powers keep the sign
+				{
+					if (!isIntegral) // a real result only for -0 and -inf, e.g. (-inf)^0.5 = inf
 					{
-						return std::numeric_limits<T>::infinity();
+						return (base == 0 || base == -inf) ? magnitude : std::numeric_limits<F>::quiet_NaN();
 					}
-					else
+					const bool isOdd = isSmall && (static_cast<long long>(exponent) % 2 != 0);
+					return isOdd ? -magnitude : magnitude;
+				}
+				return magnitude;
+			} // pow 
+
+			// element-wise evaluation of packed (SIMD) values
+			namespace detail_packed
+			{
+				template <Packed T>
+				using element_t = std::remove_cvref_t<decltype(std::declval<T&>()[0])>;
+
+				template <Packed T>
+				inline constexpr std::size_t lanes = sizeof(T) / sizeof(element_t<T>);
+
+				// pack with the lanes of T holding values of type E
+				template <typename E, std::size_t L>
+				using vector_t [[gnu::vector_size(L * sizeof(E))]] = E;
+
+				template <Packed T, Scalar E>
+				using rebind_t = std::conditional_t<std::is_same_v<element_t<T>,E>,T,vector_t<E,lanes<T> > >;
+
+				template <Packed T, typename F>
+				[[nodiscard]] constexpr T apply(T t, F func) noexcept
+				{
+					for (std::size_t i = 0; i < lanes<T>; ++i) {t[i] = func(t[i]);}
+					return t;
+				}
+			}
+
+			template <Packed T>
+			[[nodiscard]] constexpr T exp(T t) noexcept
+			{
+				if constexpr (std::is_same_v<std::remove_cvref_t<decltype(t[0])>,double>)
+				{
+					return detail_fast::exp(t);
+				}
+				else
+				{
+					return detail_packed::apply(t,[](auto val){return exp(val);});
+				}
+			}
+
+			template <Packed T>
+			[[nodiscard]] constexpr T sqrt(T t) noexcept
+			{
+				if constexpr (std::is_same_v<std::remove_cvref_t<decltype(t[0])>,double>)
+				{
+					if (!std::is_constant_evaluated())
 					{
-						if constexpr (exponent == -std::numeric_limits<U>::infinity())
-						{
-							return T(0);
-						}
-						else if constexpr (exponent == T(0))
-						{
-							return T(1);
-						}
-						else
-						{
-							if constexpr (base < T(0))
-							{
-								if constexpr (exponent == std::numeric_limits<U>::infinity())
-								{
-									return -std::numeric_limits<T>::infinity();
-								}
-								else
-								{
-									if constexpr (exponent % 2 == 0)
-									{
-										return exp(exponent * ln(-base));
-									}
-									else
-									{
-										return -exp(exponent * ln(-base));
-									}
-								}
-							}
-							else if constexpr (base == T(0))
-							{
-								return T(0);
-							}
-							else // if base > T(0)
-							{
-								if constexpr (exponent == std::numeric_limits<U>::infinity())
-								{
-									return std::numeric_limits<T>::infinity();
-								}
-								else
-								{
-									return exp(exponent * ln(base));
-								}
-							}
-						}
+						return detail_fast::sqrt(t);
 					}
 				}
-			} // pow 
+				return detail_packed::apply(t,[](auto val){return sqrt(val);});
+			}
+
+			template <Packed T>
+			[[nodiscard]] constexpr T ln(T t) noexcept
+			{
+				if constexpr (std::is_same_v<std::remove_cvref_t<decltype(t[0])>,double>)
+				{
+					return detail_fast::ln(t);
+				}
+				else
+				{
+					return detail_packed::apply(t,[](auto val){return ln(val);});
+				}
+			}
+
+			template <Packed T, Arithmetic U>
+			requires Scalar<U> || Packed<U>
+			[[nodiscard]] constexpr auto pow(T base, U exponent) noexcept
+			{
+				using E = std::conditional_t<Packed<U>,detail_packed::element_t<std::conditional_t<Packed<U>,U,T> >,U>;
+				detail_packed::rebind_t<T,pow_result_t<detail_packed::element_t<T>,E> > result{};
+				for (std::size_t i = 0; i < detail_packed::lanes<T>; ++i)
+				{
+					if constexpr (Packed<U>) {result[i] = pow(base[i],exponent[i]);}
+					else {result[i] = pow(base[i],exponent);}
+				}
+				return result;
+			}
+
+			template <Scalar T, Packed U>
+			[[nodiscard]] constexpr auto pow(T base, U exponent) noexcept
+			{
+				detail_packed::rebind_t<U,pow_result_t<T,detail_packed::element_t<U> > > result{};
+				for (std::size_t i = 0; i < detail_packed::lanes<U>; ++i)
+				{
+					result[i] = pow(base,exponent[i]);
+				}
+				return result;
+			}
 
 
 		}   
 	}
-#endif
\ No newline at end of file
+
+	#include "Jet.hxx"
+
+#endif
@@ -0,0 +1,124 @@
+#ifndef Cost_hxx
+    #define Cost_hxx
+
+    #include <algorithm>
+    #include <cstddef>
+    #include <ostream>
+
+    #include "Expressions.hxx"
+
+    namespace femto
+    {
+        namespace detail
+        {
+            // the tree which is actually evaluated: Function wrappers are transparent and a Derivative evaluates its simplified expansion
+            template <typename T>
+            struct Evaluated
+            {
+                using type = T;
+            };
+
+            template <typename T>
+            using evaluated_t = typename Evaluated<std::remove_cvref_t<T> >::type;
+
+            template <typename T>
+            struct Evaluated<Function<T> >
+            {
+                using type = std::conditional_t<Expressionlike<T>,evaluated_t<T>,Function<T> >;
+            };
+
+            template <typename T, typename U>
+            struct Evaluated<Derivative<T,U> >
+            {
+                using type = evaluated_t<decltype(std::declval<const Derivative<T,U>&>().Expand())>;
+            };
+
+            // leaves: variables, constants, literals and functions wrapping arbitrary callables
+            template <typename T>
+            struct Tree
+            {
+                static constexpr std::size_t nodes = 1;
+                static constexpr std::size_t depth = 1;
+                template <typename Op>
+                static constexpr std::size_t count = 0;
+            };
+
+            template <typename T, typename U, typename Op>
+            struct Tree<BinaryOp<T,U,Op> >
+            {
+                using Lhs = Tree<evaluated_t<T> >;
+                using Rhs = Tree<evaluated_t<U> >;
+
+                static constexpr std::size_t nodes = 1 + Lhs::nodes + Rhs::nodes;
+                static constexpr std::size_t depth = 1 + std::max(Lhs::depth,Rhs::depth);
+                template <typename O>
+                static constexpr std::size_t count = std::size_t(std::is_same_v<O,Op>) + Lhs::template count<O> + Rhs::template count<O>;
+            };
+
+            template <typename T, typename Op>
+            struct Tree<UnaryOp<T,Op> >
+            {
+                using Arg = Tree<evaluated_t<T> >;
+
+                static constexpr std::size_t nodes = 1 + Arg::nodes;
+                static constexpr std::size_t depth = 1 + Arg::depth;
+                template <typename O>
+                static constexpr std::size_t count = std::size_t(std::is_same_v<O,Op>) + Arg::template count<O>;
+            };
+        }
+
+        // number of nodes of the expanded tree of F, a repeated subtree is counted every time it appears even though a Derivative evaluates it once
+        template <typename F>
+        inline constexpr std::size_t node_count = detail::Tree<detail::evaluated_t<F> >::nodes;
+
+        // length of the longest path from the root of F to a leaf, a leaf has depth 1
+        template <typename F>
+        inline constexpr std::size_t depth = detail::Tree<detail::evaluated_t<F> >::depth;
+
+        // number of nodes of F applying the operation Op, e.g. op_count<UnaryOperations::Exponential,F>
+        template <typename Op, typename F>
+        inline constexpr std::size_t op_count = detail::Tree<detail::evaluated_t<F> >::template count<Op>;
+
+        template <typename F>
+        inline constexpr std::size_t exp_count = op_count<UnaryOperations::Exponential,F>;
+
+        template <typename F>
+        inline constexpr std::size_t ln_count = op_count<UnaryOperations::NaturalLog,F>;
+
+        template <typename F>
+        inline constexpr std::size_t pow_count = op_count<BinaryOperations::Power,F>;
+
+        template <typename F>
+        inline constexpr std::size_t sqrt_count = op_count<UnaryOperations::SquareRoot,F>;
+
+        // summary of the cost model, e.g. static_assert(cost(f).exponentials <= 2); or std::cout << cost(f);
+        struct ExpressionCost
+        {
+            std::size_t nodes = 0;
+            std::size_t depth = 0;
+            std::size_t sums = 0; // additions and subtractions
+            std::size_t products = 0;
+            std::size_t divisions = 0;
+            std::size_t powers = 0;
+            std::size_t exponentials = 0;
+            std::size_t logarithms = 0;
+            std::size_t squareRoots = 0;
+        };
+
+        template <typename F>
+        [[nodiscard]] constexpr ExpressionCost cost(const F &)
+        {
+            using namespace BinaryOperations;
+            using namespace UnaryOperations;
+            return ExpressionCost{node_count<F>,depth<F>,op_count<Sum,F> + op_count<Difference,F>,op_count<Multiplication,F>,op_count<Division,F>,
+                pow_count<F>,exp_count<F>,ln_count<F>,sqrt_count<F>};
+        }
+
+        inline std::ostream& operator<<(std::ostream &os, const ExpressionCost &cost)
+        {
+            return os << "nodes: " << cost.nodes << ", depth: " << cost.depth << ", +/-: " << cost.sums << ", *: " << cost.products << ", /: " << cost.divisions
+                << ", pow: " << cost.powers << ", exp: " << cost.exponentials << ", ln: " << cost.logarithms << ", sqrt: " << cost.squareRoots;
+        }
+    }
+
+#endif
@@ -3,6 +3,7 @@
 
     #include <array>
     #include <cmath>
+    #include <utility>
 
     #include "ConstexprMath.hxx"
 
@@ -15,8 +16,26 @@
             {
                 using type = T;
             };
+
+            // maps an argument type onto the variable type it provides a value for
+            template <typename T>
+            struct VariableOf
+            {
+                using type = T;
+            };
+
+            // defined in Simplify.hxx
+            template <typename T>
+            struct SharingPlan;
+
+            template <typename T, typename ... Args>
+            [[nodiscard]] constexpr decltype(auto) evaluate_shared(const T &expr, const SharingPlan<T> &plan, Args &&... args);
         }
 
+        // defined in Simplify.hxx
+        template <typename T>
+        [[nodiscard]] constexpr auto simplify(const T &expr);
+
         template <typename T>
         class Expression
         {
@@ -28,6 +47,10 @@
                 }
         };
 
+        // the operators below only apply to expressions, so that they do not capture e.g. iterator arithmetic inside the femto namespace
+        template <typename T>
+        concept Expressionlike = std::derived_from<std::remove_cvref_t<T>,Expression<std::remove_cvref_t<T> > >;
+
         template <typename T>
         class Function : public Expression<Function<T> >
         {
@@ -36,6 +59,7 @@
 
             public:
                 constexpr Function(T func) : m_callable(std::forward<T>(func)) {}
+                [[nodiscard]] constexpr const T& Callable() const {return m_callable;}
                 template <typename U>
                 [[nodiscard]] constexpr decltype(auto) Diff() const
                 {
@@ -48,6 +72,22 @@
                 }
         };
 
+        // integer constant known at compile-time, which allows the expressions to be simplified (see Simplify.hxx)
+        template <int V>
+        class Literal : public Expression<Literal<V> >
+        {
+            public:
+                static constexpr int value = V;
+
+                template <typename U>
+                [[nodiscard]] constexpr decltype(auto) Diff() const
+                {
+                    return Literal<0>{};
+                }
+                template <typename ...Args>
+                [[nodiscard]] constexpr int operator()(Args &&...) const {return V;}
+        };
+
         template <Arithmetic T>
         class Constant : public Expression<Constant<T> >
         {
@@ -59,7 +99,7 @@
                 template <typename U>
                 [[nodiscard]] constexpr decltype(auto) Diff() const
                 {
-                    return Constant(0);
+                    return Literal<0>{};
                 }
                 template <typename ...Args>
                 [[nodiscard]] constexpr T operator()(Args &&...) const {return m_value;}
@@ -74,17 +114,17 @@
                 {
                     if constexpr (std::is_same_v<T,U>)
                     {
-                        return Constant(1);
+                        return Literal<1>{};
                     }
                     else
                     {
-                        return Constant(0);
+                        return Literal<0>{};
                     }
                 }
                 template <typename Var, typename ... Vars>
                 [[nodiscard]] constexpr decltype(auto) operator()(Var &&first, Vars &&... rest) const
                 {
-                    if constexpr (std::is_same_v<T,Var>)
+                    if constexpr (std::is_same_v<T,typename detail::VariableOf<std::remove_cvref_t<Var> >::type>)
                     {
                         return first();
                     }
@@ -104,6 +144,8 @@
 
             public:
                 constexpr BinaryOp(T t, U u) : m_t(std::forward<T>(t)), m_u(std::forward<U>(u)) {}
+                [[nodiscard]] constexpr const T& Lhs() const {return m_t;}
+                [[nodiscard]] constexpr const U& Rhs() const {return m_u;}
                 template <typename W>
                 [[nodiscard]] constexpr decltype(auto) Diff() const
                 {
@@ -130,6 +172,11 @@
                 {
                     return lhs + rhs;
                 }
+                // local partial derivatives d(a + b)/da and d(a + b)/db
+                constexpr decltype(auto) Partials(const Arithmetic auto &, const Arithmetic auto &, const Arithmetic auto &) const
+                {
+                    return std::pair(1,1);
+                }
             };
 
             struct Difference : public Expression<Difference>
@@ -144,6 +191,10 @@
                 {
                     return lhs - rhs;
                 }
+                constexpr decltype(auto) Partials(const Arithmetic auto &, const Arithmetic auto &, const Arithmetic auto &) const
+                {
+                    return std::pair(1,-1);
+                }
             };
 
             struct Multiplication : public Expression<Multiplication>
@@ -158,6 +209,10 @@
                 {
                     return lhs * rhs;
                 }
+                constexpr decltype(auto) Partials(const Arithmetic auto &lhs, const Arithmetic auto &rhs, const Arithmetic auto &) const
+                {
+                    return std::pair(rhs,lhs);
+                }
             };
 
             struct Division : public Expression<Division>
@@ -165,13 +220,18 @@
                 template <typename T, typename U, typename W>
                 [[nodiscard]] constexpr decltype(auto) Diff(T lhsFunc, U rhsFunc) const
                 {
-                    // (a / b)' = (a' * b - a * b') / (b * b)
-                    return (lhsFunc.template Diff<W>() * rhsFunc - lhsFunc * rhsFunc.template Diff<W>()) / (rhsFunc * rhsFunc);
+                    // (a / b)' = (a' - (a / b) * b') / b
+                    return (lhsFunc.template Diff<W>() - lhsFunc / rhsFunc * rhsFunc.template Diff<W>()) / rhsFunc;
                 }
                 constexpr decltype(auto) operator()(const Arithmetic auto &lhs, const Arithmetic auto &rhs) const
                 {
                     return lhs / rhs;
                 }
+                constexpr decltype(auto) Partials(const Arithmetic auto &, const Arithmetic auto &rhs, const Arithmetic auto &result) const
+                {
+                    // d(a / b)/da = 1 / b, d(a / b)/db = -(a / b) / b
+                    return std::pair(1. / rhs,-result / rhs);
+                }
             };
             
             struct Power : public Expression<Power>
@@ -179,41 +239,51 @@
                 template <typename T, typename U, typename W>
                 [[nodiscard]] constexpr decltype(auto) Diff(T base, U exponent) const
                 {
-                    // (a ^ b)' = (exp(b * ln(a)))' = a^b * (b' * ln(a) + b / a * a')
-                    return pow(base,exponent) * (exponent.template Diff<W>() * ln(base) + exponent / base * base.template Diff<W>());
+                    // (a ^ b)' = (exp(b * ln(a)))' = a^b * ln(a) * b' + b * a^(b - 1) * a', the first term is folded away for a constant exponent
+                    return pow(base,exponent) * ln(base) * exponent.template Diff<W>() + exponent * pow(base,exponent - Literal<1>{}) * base.template Diff<W>();
                 }
                 constexpr decltype(auto) operator()(const Arithmetic auto &lhs, const Arithmetic auto &rhs) const
                 {
                     return math::pow(lhs,rhs);
                 }
+                constexpr decltype(auto) Partials(const Arithmetic auto &lhs, const Arithmetic auto &rhs, const Arithmetic auto &result) const
+                {
+                    // d(a ^ b)/da = b * a^(b - 1), d(a ^ b)/db = a^b * ln(a)
+                    return std::pair(LhsPartial(lhs,rhs,result),result * math::ln(lhs));
+                }
+                // d(a ^ b)/da alone, used when b does not depend on any variable so that ln(a) is not needed
+                constexpr decltype(auto) LhsPartial(const Arithmetic auto &lhs, const Arithmetic auto &rhs, const Arithmetic auto &) const
+                {
+                    return rhs * math::pow(lhs,rhs - 1);
+                }
             };
         } // namespace BinaryOperations
 
-        template <typename T, typename U>
+        template <Expressionlike T, Expressionlike U>
         constexpr BinaryOp<T,U,BinaryOperations::Sum> operator+(T t, U u)
         {
             return BinaryOp<T,U,BinaryOperations::Sum>(std::forward<T>(t),std::forward<U>(u));
         }
 
-        template <typename T, typename U>
+        template <Expressionlike T, Expressionlike U>
         constexpr BinaryOp<T,U,BinaryOperations::Difference> operator-(T t, U u)
         {
             return BinaryOp<T,U,BinaryOperations::Difference>(std::forward<T>(t),std::forward<U>(u));
         }
 
-        template <typename T, typename U>
+        template <Expressionlike T, Expressionlike U>
         constexpr BinaryOp<T,U,BinaryOperations::Multiplication> operator*(T t, U u)
         {
             return BinaryOp<T,U,BinaryOperations::Multiplication>(std::forward<T>(t),std::forward<U>(u));
         }
 
-        template <typename T, typename U>
+        template <Expressionlike T, Expressionlike U>
         constexpr BinaryOp<T,U,BinaryOperations::Division> operator/(T t, U u)
         {
             return BinaryOp<T,U,BinaryOperations::Division>(std::forward<T>(t),std::forward<U>(u));
         }
 
-        template <typename T, typename U>
+        template <Expressionlike T, Expressionlike U>
         constexpr BinaryOp<T,U,BinaryOperations::Power> pow(T t, U u)
         {
             return BinaryOp<T,U,BinaryOperations::Power>(std::forward<T>(t),std::forward<U>(u));
@@ -227,6 +297,7 @@
 
             public:
                 constexpr UnaryOp(T t) : m_t(std::forward<T>(t)) {}
+                [[nodiscard]] constexpr const T& Arg() const {return m_t;}
                 template <typename U>
                 [[nodiscard]] constexpr decltype(auto) Diff() const
                 {
@@ -253,6 +324,11 @@
                 {
                     return math::exp(val);
                 }
+                // local derivative d(exp(x))/dx
+                constexpr decltype(auto) Partial(const Arithmetic auto &, const Arithmetic auto &result) const
+                {
+                    return result;
+                }
             };
 
             struct Negation : public Expression<Negation>
@@ -267,6 +343,10 @@
                 {
                     return -val;
                 }
+                constexpr decltype(auto) Partial(const Arithmetic auto &, const Arithmetic auto &) const
+                {
+                    return -1;
+                }
             };
 
             struct SquareRoot : public Expression<SquareRoot>
@@ -281,6 +361,10 @@
                 {
                     return math::sqrt(val);
                 }
+                constexpr decltype(auto) Partial(const Arithmetic auto &, const Arithmetic auto &result) const
+                {
+                    return 0.5 / result;
+                }
             }; 
 
             struct NaturalLog : public Expression<NaturalLog>
@@ -295,52 +379,62 @@
                 {
                     return math::ln(val);
                 }
+                constexpr decltype(auto) Partial(const Arithmetic auto &val, const Arithmetic auto &) const
+                {
+                    return 1. / val;
+                }
             };
             
         } // namespace UnaryOperations
         
-        template <typename T>
+        template <Expressionlike T>
         constexpr UnaryOp<T,UnaryOperations::Exponential> exp(T t)
         {
             return UnaryOp<T,UnaryOperations::Exponential>(std::forward<T>(t));
         }
 
-        template <typename T>
+        template <Expressionlike T>
         constexpr UnaryOp<T,UnaryOperations::Negation> operator-(T t)
         {
             return UnaryOp<T,UnaryOperations::Negation>(std::forward<T>(t));
         }
 
-        template <typename T>
+        template <Expressionlike T>
         constexpr UnaryOp<T,UnaryOperations::SquareRoot> sqrt(T t)
         {
             return UnaryOp<T,UnaryOperations::SquareRoot>(std::forward<T>(t));
         }
 
-        template <typename T>
+        template <Expressionlike T>
         constexpr UnaryOp<T,UnaryOperations::NaturalLog> ln(T t)
         {
             return UnaryOp<T,UnaryOperations::NaturalLog>(std::forward<T>(t));
         }
 
+        // the derivative is differentiated and simplified once, on construction, which also finds its repeated subtrees
         template <typename T, typename U>
         class Derivative : public Expression<Derivative<T,U> >
         {
             private:
+                using Expanded = decltype(simplify(std::declval<const T&>().template Diff<U>()));
+
                 const T m_t;
                 const detail::DiffVariable<U> m_diff;
+                const Expanded m_expanded;
+                const detail::SharingPlan<Expanded> m_plan;
 
             public:
-                constexpr Derivative(T t, detail::DiffVariable<U> diff) : m_t(std::forward<T>(t)), m_diff(std::forward<detail::DiffVariable<U> >(diff)) {}
+                constexpr Derivative(T t, detail::DiffVariable<U> diff) : m_t(std::forward<T>(t)), m_diff(std::forward<detail::DiffVariable<U> >(diff)), m_expanded(simplify(m_t.template Diff<U>())), m_plan(m_expanded) {}
+                [[nodiscard]] constexpr const Expanded& Expand() const {return m_expanded;}
                 template <typename W>
                 [[nodiscard]] constexpr decltype(auto) Diff() const
                 {
-                    return m_t.template Diff<U>(). template Diff<W>();
+                    return simplify(m_expanded.template Diff<W>());
                 }
                 template <typename ... Args>
                 [[nodiscard]] constexpr decltype(auto) operator()(Args &&... args) const requires Functionlike<T,Args...>
                 {
-                    return m_t.template Diff<U>()(std::forward<Args>(args)...);
+                    return detail::evaluate_shared(m_expanded,m_plan,std::forward<Args>(args)...);
                 }
         };
 
@@ -354,4 +448,6 @@
         }
     }
 
+    #include "Simplify.hxx"
+
 #endif
\ No newline at end of file
@@ -0,0 +1,155 @@
+#ifndef Gradient_hxx
+    #define Gradient_hxx
+
+    #include <array>
+    #include <tuple>
+    #include <type_traits>
+
+    #include "Expressions.hxx"
+    #include "Traits.hxx"
+
+    namespace femto
+    {
+        // partial derivatives of a function with respect to each of the variables Vars
+        template <typename R, typename ... Vars>
+        class Gradient
+        {
+            private:
+                using List = detail::TypeList<Vars...>;
+
+                std::array<R,sizeof...(Vars)> m_partials;
+
+            public:
+                constexpr Gradient(std::array<R,sizeof...(Vars)> partials) : m_partials(std::move(partials)) {}
+                [[nodiscard]] constexpr const std::array<R,sizeof...(Vars)>& Partials() const {return m_partials;}
+                template <typename T>
+                [[nodiscard]] constexpr const R& get() const requires detail::contains_v<T,List>
+                {
+                    return m_partials[detail::index_of_v<T,List> ];
+                }
+                template <typename T>
+                [[nodiscard]] constexpr const R& operator[](Variable<T>) const requires detail::contains_v<T,List>
+                {
+                    return get<T>();
+                }
+                [[nodiscard]] static constexpr std::size_t size() {return sizeof...(Vars);}
+        };
+
+        template <typename R, typename ... Vars>
+        struct ValueAndGradient
+        {
+            R value;
+            Gradient<R,Vars...> gradient;
+        };
+
+        namespace detail
+        {
+            // value of a node computed during the forward sweep, together with the records of its children
+            template <typename R, typename ... Children>
+            struct Record
+            {
+                R value;
+                std::tuple<Children...> children;
+            };
+
+            template <typename T, typename ... Args>
+            [[nodiscard]] constexpr auto record(const T &expr, Args &... args)
+            {
+                if constexpr (NodeTraits<T>::isBinary && variables_t<T>::size > 0)
+                {
+                    auto lhs = record(expr.Lhs(),args...);
+                    auto rhs = record(expr.Rhs(),args...);
+                    auto value = typename NodeTraits<T>::Operation{}(lhs.value,rhs.value);
+                    return Record<decltype(value),decltype(lhs),decltype(rhs)>{value,{lhs,rhs}};
+                }
+                else if constexpr (NodeTraits<T>::isUnary && variables_t<T>::size > 0)
+                {
+                    auto arg = record(expr.Arg(),args...);
+                    auto value = typename NodeTraits<T>::Operation{}(arg.value);
+                    return Record<decltype(value),decltype(arg)>{value,{arg}};
+                }
+                else // leaves and subtrees which do not depend on any variable
+                {
+                    auto value = expr(args...);
+                    return Record<decltype(value)>{value,{}};
+                }
+            }
+
+            // propagates the adjoint of the node down to the variables
+            template <typename List, typename T, typename Rec, typename A, typename G>
+            constexpr void adjoint(const T &expr, const Rec &rec, const A &seed, G &partials)
+            {
+                if constexpr (variables_t<T>::size == 0)
+                {
+                    return;
+                }
+                else if constexpr (NodeTraits<T>::isBinary)
+                {
+                    using Op = typename NodeTraits<T>::Operation;
+                    const auto &[lhs,rhs] = rec.children;
+                    // an operation may skip the partial with respect to an operand which does not depend on any variable
+                    if constexpr (variables_t<std::remove_cvref_t<decltype(expr.Rhs())> >::size == 0 && requires {Op{}.LhsPartial(lhs.value,rhs.value,rec.value);})
+                    {
+                        adjoint<List>(expr.Lhs(),lhs,seed * Op{}.LhsPartial(lhs.value,rhs.value,rec.value),partials);
+                    }
+                    else
+                    {
+                        const auto [dlhs,drhs] = Op{}.Partials(lhs.value,rhs.value,rec.value);
+                        adjoint<List>(expr.Lhs(),lhs,seed * dlhs,partials);
+                        adjoint<List>(expr.Rhs(),rhs,seed * drhs,partials);
+                    }
+                }
+                else if constexpr (NodeTraits<T>::isUnary)
+                {
+                    const auto &arg = std::get<0>(rec.children);
+                    adjoint<List>(expr.Arg(),arg,seed * typename NodeTraits<T>::Operation{}.Partial(arg.value,rec.value),partials);
+                }
+                else // Variable
+                {
+                    partials[index_of_v<typename variables_t<T>::template At<0>,List> ] += seed;
+                }
+            }
+
+            template <typename List>
+            struct GradientOf;
+
+            template <typename ... Vars>
+            struct GradientOf<TypeList<Vars...> >
+            {
+                template <typename T, typename ... Args>
+                [[nodiscard]] static constexpr auto compute(const T &expr, Args &... args)
+                {
+                    const auto rec = record(expr,args...);
+                    using V = std::remove_cvref_t<decltype(rec.value)>;
+                    using R = std::conditional_t<std::integral<V>,double,V>;
+
+                    std::array<R,sizeof...(Vars)> partials{};
+                    adjoint<TypeList<Vars...> >(expr,rec,1.,partials);
+                    return ValueAndGradient<R,Vars...>{static_cast<R>(rec.value),Gradient<R,Vars...>(partials)};
+                }
+            };
+        }
+
+        // Returns a callable which computes the value of func and all its partial derivatives in one forward and one reverse sweep over the expression tree, e.g.
+        // auto [value,gradient] = value_and_grad(f)(X{1.},Y{2.}); double dfdx = gradient[x];
+        template <typename T>
+        [[nodiscard]] constexpr auto value_and_grad(const T &func)
+        {
+            return [expr = simplify(func)](auto &&... args)
+            {
+                return detail::GradientOf<detail::variables_t<T> >::compute(expr,args...);
+            };
+        }
+
+        // Returns a callable which computes all partial derivatives of func, the partials are ordered as the variables appear in func
+        template <typename T>
+        [[nodiscard]] constexpr auto grad(const T &func)
+        {
+            return [expr = simplify(func)](auto &&... args)
+            {
+                return detail::GradientOf<detail::variables_t<T> >::compute(expr,args...).gradient;
+            };
+        }
+    }
+
+#endif
@@ -0,0 +1,179 @@
+#ifndef Grid_hxx
+    #define Grid_hxx
+
+    #include <array>
+    #include <cassert>
+    #include <future>
+    #include <tuple>
+    #include <vector>
+
+    #include "Batch.hxx"
+    #include "ThreadPool.hxx"
+    #include "Traits.hxx"
+
+    namespace femto
+    {
+        namespace grid
+        {
+            // number of points evaluated in one task; the coordinates of a tile fit into L1/L2 cache and the tile covers whole cache lines of the output
+            inline constexpr std::size_t tile = 2048;
+        }
+
+        // points at which the variable T is sampled
+        template <typename T>
+        class Axis
+        {
+            private:
+                std::vector<double> m_points;
+
+            public:
+                // count uniformly distributed points in [min,max], including both ends
+                Axis(Variable<T>, double min, double max, std::size_t count) : m_points(count)
+                {
+                    for (std::size_t i = 0; i < count; ++i)
+                    {
+                        m_points[i] = (count == 1) ? min : min + (max - min) * static_cast<double>(i) / static_cast<double>(count - 1);
+                    }
+                }
+                Axis(Variable<T>, std::vector<double> points) : m_points(std::move(points)) {}
+                [[nodiscard]] std::size_t Size() const {return m_points.size();}
+                [[nodiscard]] const std::vector<double>& Points() const {return m_points;}
+                [[nodiscard]] double operator[](std::size_t i) const {return m_points[i];}
+        };
+
+        // Cartesian product of the axes; points are numbered in the row-major order, i.e. the last axis changes fastest
+        template <typename ... Ts>
+        class Grid
+        {
+            private:
+                static constexpr std::size_t N = sizeof...(Ts);
+
+                std::tuple<Axis<Ts>...> m_axes;
+                std::array<std::size_t,N> m_shape;
+
+                // writes the coordinates of the points [begin,begin + count) into the per-axis buffers, one run of the last axis at a time
+                void Coordinates(std::size_t begin, std::size_t count, std::array<std::vector<double>,N> &coords) const
+                {
+                    std::array<std::size_t,N> index = Unravel(begin);
+                    const std::size_t inner = m_shape[N - 1];
+                    std::size_t written = 0;
+                    while (written < count)
+                    {
+                        const std::size_t run = std::min(inner - index[N - 1],count - written);
+                        [&]<std::size_t ... Is>(std::index_sequence<Is...>)
+                        {
+                            ((Is == N - 1
+                                ? (void)std::copy_n(std::get<Is>(m_axes).Points().begin() + index[Is],run,coords[Is].begin() + written)
+                                : (void)std::fill_n(coords[Is].begin() + written,run,std::get<Is>(m_axes)[index[Is]])), ...);
+                        }(std::make_index_sequence<N>{});
+                        written += run;
+
+                        // carry the index over to the outer axes
+                        index[N - 1] += run;
+                        for (std::size_t d = N - 1; d > 0 && index[d] == m_shape[d]; --d)
+                        {
+                            index[d] = 0;
+                            ++index[d - 1];
+                        }
+                    }
+                }
+
+                template <typename F>
+                void EvaluateRange(const F &func, std::size_t begin, std::span<double> out, ThreadPool &pool) const
+                {
+                    pool.ParallelFor(out.size(),grid::tile,[&](std::size_t first, std::size_t last, std::size_t)
+                    {
+                        thread_local std::array<std::vector<double>,N> coords;
+                        for (auto &axis : coords) {axis.resize(grid::tile);}
+
+                        for (std::size_t pos = first; pos < last; pos += grid::tile)
+                        {
+                            const std::size_t count = std::min(grid::tile,last - pos);
+                            Coordinates(begin + pos,count,coords);
+                            [&]<std::size_t ... Is>(std::index_sequence<Is...>)
+                            {
+                                evaluate<Ts...>(func,out.subspan(pos,count),std::span<const double>(coords[Is].data(),count)...);
+                            }(std::make_index_sequence<N>{});
+                        }
+                    });
+                }
+
+                template <typename F>
+                static constexpr void CheckVariables()
+                {
+                    static_assert([]<typename ... Vs>(detail::TypeList<Vs...>){return (detail::contains_v<Vs,detail::TypeList<Ts...> > && ...);}(detail::variables_t<F>{}),
+                        "every variable of the function needs an axis of the grid");
+                }
+
+            public:
+                Grid(Axis<Ts>... axes) : m_axes(std::move(axes)...), m_shape{std::get<Axis<Ts> >(m_axes).Size()...} {}
+                [[nodiscard]] const std::array<std::size_t,N>& Shape() const {return m_shape;}
+                [[nodiscard]] std::size_t Size() const
+                {
+                    std::size_t size = 1;
+                    for (const auto &dim : m_shape) {size *= dim;}
+                    return size;
+                }
+                template <typename T>
+                [[nodiscard]] const Axis<T>& GetAxis() const {return std::get<Axis<T> >(m_axes);}
+
+                // position of the point in the row-major order
+                [[nodiscard]] std::size_t Index(const std::array<std::size_t,N> &index) const
+                {
+                    std::size_t flat = 0;
+                    for (std::size_t d = 0; d < N; ++d) {flat = flat * m_shape[d] + index[d];}
+                    return flat;
+                }
+                [[nodiscard]] std::array<std::size_t,N> Unravel(std::size_t flat) const
+                {
+                    std::array<std::size_t,N> index{};
+                    for (std::size_t d = N; d-- > 0;)
+                    {
+                        index[d] = flat % m_shape[d];
+                        flat /= m_shape[d];
+                    }
+                    return index;
+                }
+
+                // evaluates func (Function, Derivative or any other expression) at every point of the grid and writes the values in the row-major order
+                template <typename F>
+                void Evaluate(const F &func, std::span<double> out, ThreadPool &pool = default_pool()) const
+                {
+                    CheckVariables<F>();
+                    assert(out.size() == Size());
+                    EvaluateRange(func,0,out,pool);
+                }
+
+                template <typename F>
+                [[nodiscard]] std::vector<double> Evaluate(const F &func, ThreadPool &pool = default_pool()) const
+                {
+                    std::vector<double> values(Size());
+                    Evaluate(func,values,pool);
+                    return values;
+                }
+
+                // Evaluates func in chunks of chunkSize points and passes each of them, in order, to sink(offset,values), where offset is the index of the first point of the chunk.
+                // The sink of one chunk runs while the next one is computed, so only two chunks are kept in memory at any time.
+                template <typename F, typename Sink>
+                void Stream(const F &func, std::size_t chunkSize, Sink &&sink, ThreadPool &pool = default_pool()) const
+                {
+                    CheckVariables<F>();
+                    const std::size_t size = Size();
+                    chunkSize = std::max<std::size_t>(chunkSize,1);
+
+                    std::array<std::vector<double>,2> buffers{std::vector<double>(std::min(chunkSize,size)),std::vector<double>(std::min(chunkSize,size))};
+                    std::future<void> pending;
+                    for (std::size_t offset = 0, chunk = 0; offset < size; offset += chunkSize, ++chunk)
+                    {
+                        std::span<double> out(buffers[chunk % 2].data(),std::min(chunkSize,size - offset));
+                        EvaluateRange(func,offset,out,pool);
+
+                        if (pending.valid()) {pending.get();}
+                        pending = std::async(std::launch::async,[&sink,offset,out]{sink(offset,std::span<const double>(out));});
+                    }
+                    if (pending.valid()) {pending.get();}
+                }
+        };
+    }
+
+#endif
@@ -0,0 +1,406 @@
+#ifndef Integration_hxx
+    #define Integration_hxx
+
+    #include <algorithm>
+    #include <array>
+    #include <bit>
+    #include <cstdint>
+    #include <random>
+    #include <tuple>
+    #include <vector>
+
+    #include "Batch.hxx"
+    #include "ThreadPool.hxx"
+    #include "Traits.hxx"
+
+    namespace femto
+    {
+        // integration limits of the variable T, lower > upper gives the integral with the opposite sign
+        template <typename T>
+        struct Bounds
+        {
+            double min;
+            double max;
+
+            Bounds(Variable<T>, double lower, double upper) : min(lower), max(upper) {}
+        };
+
+        struct IntegrationResult
+        {
+            double value = 0;
+            double error = 0; // estimate of the absolute error
+            std::size_t evaluations = 0;
+        };
+
+        struct CubatureSettings
+        {
+            double relativeTolerance = 1e-6;
+            double absoluteTolerance = 0;
+            std::size_t maxEvaluations = 100'000'000;
+        };
+
+        struct QuasiMonteCarloSettings
+        {
+            std::size_t points = 1 << 20; // per replicate, rounded up to a power of 2 and limited to 2^32, the length of the 32 bit sequence
+            std::size_t replicates = 8; // independently scrambled sequences, which give the error estimate
+            std::uint64_t seed = 42;
+        };
+
+        namespace detail
+        {
+            template <typename F, typename ... Ts>
+            constexpr void check_bounds()
+            {
+                static_assert([]<typename ... Vs>(TypeList<Vs...>){return (contains_v<Vs,TypeList<Ts...> > && ...);}(variables_t<F>{}),
+                    "every variable of the function needs integration bounds");
+            }
+
+            // evaluates func at the points given by per-axis coordinate buffers, each holding count values
+            template <typename ... Ts, typename F, std::size_t N>
+            void evaluate_points(const F &func, const std::array<std::vector<double>,N> &coords, std::size_t count, std::vector<double> &values)
+            {
+                values.resize(count);
+                [&]<std::size_t ... Is>(std::index_sequence<Is...>)
+                {
+                    evaluate<Ts...>(func,std::span<double>(values.data(),count),std::span<const double>(coords[Is].data(),count)...);
+                }(std::make_index_sequence<N>{});
+            }
+        }
+
+        // Globally adaptive cubature with the degree 7 rule of Genz and Malik (degree 5 embedded rule for the error estimate).
+        // Suited for low dimensions: the rule uses 2^n + 2n^2 + 2n + 1 points per subregion.
+        template <typename ... Ts>
+        class Cubature
+        {
+            private:
+                static constexpr std::size_t N = sizeof...(Ts);
+                static constexpr std::size_t Points = 1 + 4 * N + 2 * N * (N - 1) + (std::size_t(1) << N);
+
+                struct Region
+                {
+                    std::array<double,N> center;
+                    std::array<double,N> halfWidth;
+                    double value = 0;
+                    double error = 0;
+                    std::size_t splitAxis = 0;
+
+                    bool operator<(const Region &other) const {return error < other.error;}
+                };
+
+                // nodes of the rule on [-1,1]^n: the center, then (+l2,-l2,+l3,-l3) along each axis, then (+-l4,+-l4) for each pair of axes, then the corners (+-l5,...)
+                struct Rule
+                {
+                    std::array<std::array<double,N>,Points> nodes{};
+                    std::array<double,Points> weights7{};
+                    std::array<double,Points> weights5{};
+
+                    Rule()
+                    {
+                        const double n = N;
+                        const double l2 = std::sqrt(9. / 70.), l3 = std::sqrt(9. / 10.), l4 = std::sqrt(9. / 10.), l5 = std::sqrt(9. / 19.);
+                        const double w1 = (12824. - 9120. * n + 400. * n * n) / 19683., w2 = 980. / 6561., w3 = (1820. - 400. * n) / 19683., w4 = 200. / 19683., w5 = 6859. / 19683. / static_cast<double>(std::size_t(1) << N);
+                        const double v1 = (729. - 950. * n + 50. * n * n) / 729., v2 = 245. / 486., v3 = (265. - 100. * n) / 1458., v4 = 25. / 729.;
+
+                        std::size_t p = 0;
+                        auto add = [&](std::array<double,N> node, double w7, double w5)
+                        {
+                            nodes[p] = node;
+                            weights7[p] = w7;
+                            weights5[p] = w5;
+                            ++p;
+                        };
+
+                        add({},w1,v1);
+                        for (std::size_t i = 0; i < N; ++i)
+                        {
+                            std::array<double,N> node{};
+                            for (const double val : {l2,-l2}) {node[i] = val; add(node,w2,v2);}
+                            for (const double val : {l3,-l3}) {node[i] = val; add(node,w3,v3);}
+                        }
+                        for (std::size_t i = 0; i < N; ++i)
+                        {
+                            for (std::size_t j = i + 1; j < N; ++j)
+                            {
+                                for (const double a : {l4,-l4})
+                                {
+                                    for (const double b : {l4,-l4})
+                                    {
+                                        std::array<double,N> node{};
+                                        node[i] = a;
+                                        node[j] = b;
+                                        add(node,w4,v4);
+                                    }
+                                }
+                            }
+                        }
+                        for (std::size_t corner = 0; corner < (std::size_t(1) << N); ++corner)
+                        {
+                            std::array<double,N> node{};
+                            for (std::size_t i = 0; i < N; ++i) {node[i] = (corner >> i & 1) ? -l5 : l5;}
+                            add(node,w5,0.);
+                        }
+                    }
+                };
+
+                std::array<double,N> m_min;
+                std::array<double,N> m_max;
+
+                // applies the rule to the regions, evaluating all their points in one batch
+                template <typename F>
+                static void Estimate(const F &func, const Rule &rule, std::span<Region> regions)
+                {
+                    thread_local std::array<std::vector<double>,N> coords;
+                    thread_local std::vector<double> values;
+                    for (auto &axis : coords) {axis.resize(regions.size() * Points);}
+
+                    for (std::size_t r = 0; r < regions.size(); ++r)
+                    {
+                        for (std::size_t p = 0; p < Points; ++p)
+                        {
+                            for (std::size_t d = 0; d < N; ++d)
+                            {
+                                coords[d][r * Points + p] = regions[r].center[d] + regions[r].halfWidth[d] * rule.nodes[p][d];
+                            }
+                        }
+                    }
+                    detail::evaluate_points<Ts...>(func,coords,regions.size() * Points,values);
+
+                    constexpr double ratio = (9. / 70.) / (9. / 10.); // l2^2 / l3^2
+                    for (std::size_t r = 0; r < regions.size(); ++r)
+                    {
+                        const double *f = values.data() + r * Points;
+                        double volume = 1;
+                        for (const auto &half : regions[r].halfWidth) {volume *= 2 * half;}
+
+                        double sum7 = 0, sum5 = 0;
+                        for (std::size_t p = 0; p < Points; ++p)
+                        {
+                            sum7 += rule.weights7[p] * f[p];
+                            sum5 += rule.weights5[p] * f[p];
+                        }
+                        regions[r].value = volume * sum7;
+                        // The difference to the embedded rule is the error estimate of Genz and Malik. It measures the error of the degree 5 rule,
+                        // so for smooth integrands the value of the degree 7 rule is usually far more accurate than the estimate suggests.
+                        regions[r].error = std::abs(volume * (sum7 - sum5)); // the volume is negative for an odd number of reversed bounds
+
+                        // the region is later split along the axis with the largest fourth difference
+                        double largest = -1;
+                        for (std::size_t d = 0; d < N; ++d)
+                        {
+                            const double diff = std::abs(f[1 + 4 * d] + f[2 + 4 * d] - 2 * f[0] - ratio * (f[3 + 4 * d] + f[4 + 4 * d] - 2 * f[0]));
+                            if (diff > largest)
+                            {
+                                largest = diff;
+                                regions[r].splitAxis = d;
+                            }
+                        }
+                    }
+                }
+
+            public:
+                Cubature(Bounds<Ts>... bounds) : m_min{bounds.min...}, m_max{bounds.max...} {}
+
+                template <typename F>
+                [[nodiscard]] IntegrationResult Integrate(const F &func, const CubatureSettings &settings = {}, ThreadPool &pool = default_pool()) const
+                {
+                    detail::check_bounds<F,Ts...>();
+                    static const Rule rule;
+
+                    std::vector<Region> heap(1);
+                    for (std::size_t d = 0; d < N; ++d)
+                    {
+                        heap[0].center[d] = (m_min[d] + m_max[d]) / 2;
+                        heap[0].halfWidth[d] = (m_max[d] - m_min[d]) / 2;
+                    }
+                    Estimate(func,rule,std::span<Region>(heap));
+
+                    IntegrationResult result{heap[0].value,heap[0].error,Points};
+                    std::vector<Region> children;
+                    while (result.error > std::max(settings.absoluteTolerance,settings.relativeTolerance * std::abs(result.value)) && result.evaluations < settings.maxEvaluations)
+                    {
+                        // the regions with the largest errors are split in two and the halves are estimated in parallel
+                        const std::size_t count = std::min(heap.size(),std::max<std::size_t>(pool.Size() * 16,heap.size() / 8));
+                        children.clear();
+                        for (std::size_t i = 0; i < count; ++i)
+                        {
+                            std::pop_heap(heap.begin(),heap.end());
+                            Region parent = heap.back();
+                            heap.pop_back();
+
+                            const std::size_t axis = parent.splitAxis;
+                            parent.halfWidth[axis] /= 2;
+                            for (const double side : {-1.,1.})
+                            {
+                                Region child = parent;
+                                child.center[axis] += side * parent.halfWidth[axis];
+                                children.push_back(child);
+                            }
+                        }
+                        pool.ParallelFor(children.size(),std::max<std::size_t>(1,1024 / Points),[&](std::size_t first, std::size_t last, std::size_t)
+                        {
+                            Estimate(func,rule,std::span<Region>(children.data() + first,last - first));
+                        });
+                        for (const auto &child : children)
+                        {
+                            heap.push_back(child);
+                            std::push_heap(heap.begin(),heap.end());
+                        }
+
+                        // the totals are summed anew to avoid accumulating rounding errors
+                        result.value = 0;
+                        result.error = 0;
+                        for (const auto &region : heap)
+                        {
+                            result.value += region.value;
+                            result.error += region.error;
+                        }
+                        result.evaluations += children.size() * Points;
+                    }
+                    return result;
+                }
+        };
+
+        namespace detail
+        {
+            // direction numbers of Joe and Kuo (new-joe-kuo-6.21201) for the dimensions 2..21: degree s, coefficients a and initial m_1..m_s of the primitive polynomial
+            struct SobolPolynomial
+            {
+                unsigned s;
+                unsigned a;
+                std::array<unsigned,7> m;
+            };
+
+            inline constexpr std::array<SobolPolynomial,20> sobolPolynomials{{
+                {1,0,{1}},{2,1,{1,3}},{3,1,{1,3,1}},{3,2,{1,1,1}},{4,1,{1,1,3,3}},{4,4,{1,3,5,13}},
+                {5,2,{1,1,5,5,17}},{5,4,{1,1,5,5,5}},{5,7,{1,1,7,11,19}},{5,11,{1,1,5,1,1}},{5,13,{1,1,1,3,11}},{5,14,{1,3,5,5,31}},
+                {6,1,{1,3,3,9,7,49}},{6,13,{1,1,1,15,21,21}},{6,16,{1,3,1,13,27,49}},{6,19,{1,1,1,15,7,5}},{6,22,{1,3,1,15,13,25}},{6,25,{1,1,5,5,19,61}},
+                {7,1,{1,3,7,11,23,15,103}},{7,4,{1,3,7,13,13,15,69}}
+            }};
+
+            // 32 direction numbers of one dimension of the Sobol sequence
+            inline std::array<std::uint32_t,32> sobol_directions(std::size_t dimension)
+            {
+                std::array<std::uint32_t,32> v{};
+                if (dimension == 0)
+                {
+                    for (unsigned k = 0; k < 32; ++k) {v[k] = std::uint32_t(1) << (31 - k);}
+                    return v;
+                }
+                const SobolPolynomial &poly = sobolPolynomials[dimension - 1];
+                for (unsigned k = 0; k < 32; ++k)
+                {
+                    if (k < poly.s)
+                    {
+                        v[k] = poly.m[k] << (31 - k);
+                    }
+                    else
+                    {
+                        v[k] = v[k - poly.s] ^ (v[k - poly.s] >> poly.s);
+                        for (unsigned j = 1; j < poly.s; ++j)
+                        {
+                            if ((poly.a >> (poly.s - 1 - j)) & 1) {v[k] ^= v[k - j];}
+                        }
+                    }
+                }
+                return v;
+            }
+        }
+
+        // Randomised quasi-Monte Carlo integration with scrambled (random digital shift) Sobol sequences, suited for higher dimensions.
+        // The error is estimated from the spread of the independently scrambled replicates.
+        template <typename ... Ts>
+        class QuasiMonteCarlo
+        {
+            private:
+                static constexpr std::size_t N = sizeof...(Ts);
+                static_assert(N <= detail::sobolPolynomials.size() + 1,"direction numbers are tabulated only up to 21 dimensions");
+
+                static constexpr std::size_t block = 4096; // points generated and evaluated at once
+
+                std::array<double,N> m_min;
+                std::array<double,N> m_max;
+
+            public:
+                QuasiMonteCarlo(Bounds<Ts>... bounds) : m_min{bounds.min...}, m_max{bounds.max...} {}
+
+                template <typename F>
+                [[nodiscard]] IntegrationResult Integrate(const F &func, const QuasiMonteCarloSettings &settings = {}, ThreadPool &pool = default_pool()) const
+                {
+                    detail::check_bounds<F,Ts...>();
+
+                    std::array<std::array<std::uint32_t,32>,N> directions;
+                    for (std::size_t d = 0; d < N; ++d) {directions[d] = detail::sobol_directions(d);}
+
+                    const std::size_t points = std::bit_ceil(std::clamp<std::size_t>(settings.points,block,std::size_t(1) << 32));
+                    const std::size_t replicates = std::max<std::size_t>(settings.replicates,2);
+                    std::mt19937_64 gen(settings.seed);
+                    std::vector<std::array<std::uint32_t,N> > shifts(replicates);
+                    for (auto &shift : shifts)
+                    {
+                        for (auto &val : shift) {val = static_cast<std::uint32_t>(gen());}
+                    }
+
+                    double volume = 1;
+                    for (std::size_t d = 0; d < N; ++d) {volume *= m_max[d] - m_min[d];}
+
+                    // sums of the blocks, each replicate consists of points / block blocks
+                    const std::size_t blocks = points / block;
+                    std::vector<double> sums(replicates * blocks);
+                    pool.ParallelFor(sums.size(),1,[&](std::size_t first, std::size_t last, std::size_t)
+                    {
+                        thread_local std::array<std::vector<double>,N> coords;
+                        thread_local std::vector<double> values;
+                        for (auto &axis : coords) {axis.resize(block);}
+
+                        for (std::size_t job = first; job < last; ++job)
+                        {
+                            const auto &shift = shifts[job / blocks];
+                            const std::size_t start = (job % blocks) * block;
+
+                            // point number start in the Gray code order, the next ones differ by a single direction number
+                            std::array<std::uint32_t,N> x = shift;
+                            const std::size_t gray = start ^ (start >> 1);
+                            for (unsigned k = 0; k < 32; ++k)
+                            {
+                                if ((gray >> k) & 1)
+                                {
+                                    for (std::size_t d = 0; d < N; ++d) {x[d] ^= directions[d][k];}
+                                }
+                            }
+                            for (std::size_t i = 0; i < block; ++i)
+                            {
+                                // point n differs from point n - 1 in the direction number of the lowest set bit of n, which is below 32 as n < 2^32
+                                if (i > 0)
+                                {
+                                    const unsigned bit = std::countr_zero(start + i);
+                                    for (std::size_t d = 0; d < N; ++d) {x[d] ^= directions[d][bit];}
+                                }
+                                for (std::size_t d = 0; d < N; ++d)
+                                {
+                                    coords[d][i] = m_min[d] + (m_max[d] - m_min[d]) * ((x[d] + 0.5) * 0x1p-32);
+                                }
+                            }
+
+                            detail::evaluate_points<Ts...>(func,coords,block,values);
+                            double sum = 0;
+                            for (const auto &val : values) {sum += val;}
+                            sums[job] = sum;
+                        }
+                    });
+
+                    double mean = 0, variance = 0;
+                    std::vector<double> estimates(replicates);
+                    for (std::size_t r = 0; r < replicates; ++r)
+                    {
+                        for (std::size_t b = 0; b < blocks; ++b) {estimates[r] += sums[r * blocks + b];}
+                        estimates[r] *= volume / static_cast<double>(points);
+                        mean += estimates[r] / static_cast<double>(replicates);
+                    }
+                    for (const auto &estimate : estimates) {variance += (estimate - mean) * (estimate - mean) / static_cast<double>(replicates - 1);}
+
+                    return {mean,std::sqrt(variance / static_cast<double>(replicates)),points * replicates};
+                }
+        };
+    }
+
+#endif
@@ -0,0 +1,212 @@
+#ifndef Jet_hxx
+    #define Jet_hxx
+
+    #include <array>
+    #include <cstddef>
+
+    #include "ConstexprMath.hxx"
+
+    namespace femto
+    {
+        // Truncated Taylor series f(x0 + h) = c_0 + c_1 h + ... + c_N h^N, i.e. c_k = f^(k)(x0) / k!.
+        // Evaluating an expression on jets propagates the first N derivatives through every node in O(N^2) operations per node.
+        template <std::size_t N>
+        class Jet
+        {
+            private:
+                std::array<double,N + 1> m_coefficients{};
+
+            public:
+                static constexpr std::size_t order = N;
+
+                constexpr Jet() = default;
+                // constant, all the derivatives vanish
+                explicit constexpr Jet(double value) : m_coefficients{value} {}
+                explicit constexpr Jet(const std::array<double,N + 1> &coefficients) : m_coefficients(coefficients) {}
+                // the independent variable at x0, its first derivative is 1
+                [[nodiscard]] static constexpr Jet Seed(double x0)
+                {
+                    Jet jet(x0);
+                    if constexpr (N > 0) {jet[1] = 1.;}
+                    return jet;
+                }
+
+                [[nodiscard]] constexpr double operator[](std::size_t k) const {return m_coefficients[k];}
+                [[nodiscard]] constexpr double& operator[](std::size_t k) {return m_coefficients[k];}
+                [[nodiscard]] constexpr const std::array<double,N + 1>& Coefficients() const {return m_coefficients;}
+                [[nodiscard]] constexpr double Value() const {return m_coefficients[0];}
+                // f, f', ..., f^(N)
+                [[nodiscard]] constexpr std::array<double,N + 1> Derivatives() const
+                {
+                    std::array<double,N + 1> derivatives = m_coefficients;
+                    double factorial = 1.;
+                    for (std::size_t k = 1; k <= N; ++k)
+                    {
+                        factorial *= static_cast<double>(k);
+                        derivatives[k] *= factorial;
+                    }
+                    return derivatives;
+                }
+        };
+
+        template <std::size_t N>
+        [[nodiscard]] constexpr Jet<N> operator-(Jet<N> a)
+        {
+            for (std::size_t k = 0; k <= N; ++k) {a[k] = -a[k];}
+            return a;
+        }
+
+        template <std::size_t N>
+        [[nodiscard]] constexpr Jet<N> operator+(Jet<N> a, const Jet<N> &b)
+        {
+            for (std::size_t k = 0; k <= N; ++k) {a[k] += b[k];}
+            return a;
+        }
+
+        template <std::size_t N>
+        [[nodiscard]] constexpr Jet<N> operator-(Jet<N> a, const Jet<N> &b)
+        {
+            for (std::size_t k = 0; k <= N; ++k) {a[k] -= b[k];}
+            return a;
+        }
+
+        // Cauchy product
+        template <std::size_t N>
+        [[nodiscard]] constexpr Jet<N> operator*(const Jet<N> &a, const Jet<N> &b)
+        {
+            Jet<N> c;
+            for (std::size_t k = 0; k <= N; ++k)
+            {
+                for (std::size_t j = 0; j <= k; ++j) {c[k] += a[j] * b[k - j];}
+            }
+            return c;
+        }
+
+        // c = a / b solves c * b = a order by order
+        template <std::size_t N>
+        [[nodiscard]] constexpr Jet<N> operator/(const Jet<N> &a, const Jet<N> &b)
+        {
+            Jet<N> c;
+            for (std::size_t k = 0; k <= N; ++k)
+            {
+                double sum = a[k];
+                for (std::size_t j = 1; j <= k; ++j) {sum -= b[j] * c[k - j];}
+                c[k] = sum / b[0];
+            }
+            return c;
+        }
+
+        template <std::size_t N, Scalar S>
+        [[nodiscard]] constexpr Jet<N> operator+(Jet<N> a, S s) {a[0] += static_cast<double>(s); return a;}
+        template <std::size_t N, Scalar S>
+        [[nodiscard]] constexpr Jet<N> operator+(S s, Jet<N> a) {a[0] += static_cast<double>(s); return a;}
+        template <std::size_t N, Scalar S>
+        [[nodiscard]] constexpr Jet<N> operator-(Jet<N> a, S s) {a[0] -= static_cast<double>(s); return a;}
+        template <std::size_t N, Scalar S>
+        [[nodiscard]] constexpr Jet<N> operator-(S s, const Jet<N> &a) {return -a + s;}
+
+        template <std::size_t N, Scalar S>
+        [[nodiscard]] constexpr Jet<N> operator*(Jet<N> a, S s)
+        {
+            for (std::size_t k = 0; k <= N; ++k) {a[k] *= static_cast<double>(s);}
+            return a;
+        }
+        template <std::size_t N, Scalar S>
+        [[nodiscard]] constexpr Jet<N> operator*(S s, const Jet<N> &a) {return a * s;}
+        template <std::size_t N, Scalar S>
+        [[nodiscard]] constexpr Jet<N> operator/(const Jet<N> &a, S s) {return a * (1. / static_cast<double>(s));}
+        template <std::size_t N, Scalar S>
+        [[nodiscard]] constexpr Jet<N> operator/(S s, const Jet<N> &a) {return Jet<N>(static_cast<double>(s)) / a;}
+
+        // the recurrences below follow from differentiating b = f(a), e.g. b' = b a' for the exponential, and comparing the coefficients
+        namespace math
+        {
+            template <Taylor T>
+            [[nodiscard]] constexpr T exp(T a) noexcept
+            {
+                T b;
+                b[0] = exp(a[0]);
+                for (std::size_t k = 1; k <= T::order; ++k)
+                {
+                    double sum = 0.;
+                    for (std::size_t j = 1; j <= k; ++j) {sum += static_cast<double>(j) * a[j] * b[k - j];}
+                    b[k] = sum / static_cast<double>(k);
+                }
+                return b;
+            }
+
+            // a' = a b'
+            template <Taylor T>
+            [[nodiscard]] constexpr T ln(T a) noexcept
+            {
+                T b;
+                b[0] = ln(a[0]);
+                for (std::size_t k = 1; k <= T::order; ++k)
+                {
+                    double sum = static_cast<double>(k) * a[k];
+                    for (std::size_t j = 1; j < k; ++j) {sum -= static_cast<double>(j) * b[j] * a[k - j];}
+                    b[k] = sum / (static_cast<double>(k) * a[0]);
+                }
+                return b;
+            }
+
+            // b * b = a
+            template <Taylor T>
+            [[nodiscard]] constexpr T sqrt(T a) noexcept
+            {
+                T b;
+                b[0] = sqrt(a[0]);
+                for (std::size_t k = 1; k <= T::order; ++k)
+                {
+                    double sum = a[k];
+                    for (std::size_t j = 1; j < k; ++j) {sum -= b[j] * b[k - j];}
+                    b[k] = sum / (2. * b[0]);
+                }
+                return b;
+            }
+
+            // a b' = p a' b for b = a^p with a constant exponent p
+            template <Taylor T, Arithmetic U>
+            requires Scalar<U> || Taylor<U>
+            [[nodiscard]] constexpr T pow(T base, U exponent) noexcept
+            {
+                if constexpr (Taylor<U>)
+                {
+                    return exp(exponent * ln(base));
+                }
+                else
+                {
+                    // integral exponents by repeated squaring, which also works for a vanishing base
+                    const double p = static_cast<double>(exponent);
+                    if (p == static_cast<double>(static_cast<long long>(p)) && p >= -64 && p <= 64)
+                    {
+                        T result(1.);
+                        for (unsigned long long n = (p < 0) ? -static_cast<long long>(p) : static_cast<long long>(p); n > 0; n >>= 1)
+                        {
+                            if (n & 1) {result = result * base;}
+                            base = base * base;
+                        }
+                        return (p < 0) ? 1. / result : result;
+                    }
+
+                    T b;
+                    b[0] = pow(base[0],p);
+                    for (std::size_t k = 1; k <= T::order; ++k)
+                    {
+                        double sum = 0.;
+                        for (std::size_t j = 1; j <= k; ++j) {sum += ((p + 1.) * static_cast<double>(j) - static_cast<double>(k)) * base[j] * b[k - j];}
+                        b[k] = sum / (static_cast<double>(k) * base[0]);
+                    }
+                    return b;
+                }
+            }
+
+            template <Scalar T, Taylor U>
+            [[nodiscard]] constexpr U pow(T base, U exponent) noexcept
+            {
+                return exp(exponent * ln(static_cast<double>(base)));
+            }
+        }
+    }
+
+#endif
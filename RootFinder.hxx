@@ -0,0 +1,263 @@
+#ifndef RootFinder_hxx
+    #define RootFinder_hxx
+
+    #include <algorithm>
+    #include <array>
+    #include <cassert>
+    #include <cstdint>
+    #include <limits>
+    #include <span>
+    #include <tuple>
+    #include <vector>
+
+    #include "Batch.hxx"
+    #include "ThreadPool.hxx"
+    #include "Traits.hxx"
+
+    namespace femto
+    {
+        // values of the unknown T, one per problem: the starting points on input, the roots on output
+        template <typename T>
+        struct Unknown
+        {
+            std::span<double> values;
+
+            Unknown(Variable<T>, std::span<double> start) : values(start) {}
+        };
+
+        // values of the parameter T, one per problem, which stay fixed during the iterations
+        template <typename T>
+        struct Parameter
+        {
+            std::span<const double> values;
+
+            Parameter(Variable<T>, std::span<const double> fixed) : values(fixed) {}
+        };
+
+        struct NewtonSettings
+        {
+            double relativeTolerance = 1e-12; // a problem converges once |dx| <= absoluteTolerance + relativeTolerance * |x| for all its unknowns
+            double absoluteTolerance = 1e-14;
+            std::size_t maxIterations = 50;
+        };
+
+        enum class NewtonStatus : std::uint8_t
+        {
+            Converged,
+            MaxIterations,
+            Singular, // the Jacobian has no inverse at the last iterate
+            NotFinite // the iterate overflowed or became nan
+        };
+
+        struct NewtonResult
+        {
+            std::vector<NewtonStatus> status; // one per problem
+            std::vector<std::uint32_t> iterations; // one per problem
+            std::size_t converged = 0;
+        };
+
+        namespace newton
+        {
+            // number of packs of problems solved in one task
+            inline constexpr std::size_t grain = 16;
+        }
+
+        // Newton-Raphson method for the system f_i(x) = 0, with as many equations as unknowns. The Jacobian is built at compile-time from the derivatives
+        // of every equation with respect to every unknown. Many independent problems (starting points and/or parameter sets) are solved at once: each SIMD lane
+        // carries one problem and is frozen as soon as it stops, while the packs of lanes are spread over a thread pool.
+        template <typename ... Fs>
+        class Newton
+        {
+            private:
+                static constexpr std::size_t N = sizeof...(Fs);
+                static constexpr std::size_t W = batch::width;
+
+                using Pack = batch::Pack;
+                using Mask = decltype(Pack{} < Pack{});
+
+                std::tuple<Fs...> m_equations;
+
+                [[nodiscard]] static Pack abs(Pack value) {return value < 0. ? -value : value;}
+                [[nodiscard]] static Mask finite(Pack value) {return (value == value) & (abs(value) <= std::numeric_limits<double>::max());}
+                [[nodiscard]] static bool any(Mask mask)
+                {
+                    for (std::size_t i = 0; i < W; ++i)
+                    {
+                        if (mask[i]) {return true;}
+                    }
+                    return false;
+                }
+
+                template <typename R>
+                [[nodiscard]] static Pack to_pack(R result)
+                {
+                    if constexpr (Packed<R>)
+                    {
+                        return result;
+                    }
+                    else // the entry does not depend on any of the variables
+                    {
+                        return Pack{} + static_cast<double>(result);
+                    }
+                }
+
+                // entry (i,j) of the Jacobian, stored at i * N + j, is the derivative of the i-th equation with respect to the j-th unknown
+                template <typename ... Us>
+                [[nodiscard]] auto Jacobian() const
+                {
+                    return [&]<std::size_t ... Is>(std::index_sequence<Is...>)
+                    {
+                        return std::make_tuple(d(std::get<Is / N>(m_equations),diff_wrt(Variable<typename detail::TypeList<Us...>::template At<Is % N> >{}))...);
+                    }(std::make_index_sequence<N * N>{});
+                }
+
+                // Gaussian elimination of a * dx = b in every lane, with partial pivoting chosen per lane
+                [[nodiscard]] static std::array<Pack,N> LinearSolve(std::array<std::array<Pack,N>,N> &a, std::array<Pack,N> &b, Mask &singular)
+                {
+                    for (std::size_t k = 0; k < N; ++k)
+                    {
+                        for (std::size_t r = k + 1; r < N; ++r)
+                        {
+                            const Mask swap = abs(a[r][k]) > abs(a[k][k]);
+                            for (std::size_t c = k; c < N; ++c)
+                            {
+                                const Pack top = a[k][c];
+                                a[k][c] = swap ? a[r][c] : top;
+                                a[r][c] = swap ? top : a[r][c];
+                            }
+                            const Pack top = b[k];
+                            b[k] = swap ? b[r] : top;
+                            b[r] = swap ? top : b[r];
+                        }
+                        singular |= (a[k][k] == 0.);
+
+                        const Pack inverse = 1. / a[k][k];
+                        for (std::size_t r = k + 1; r < N; ++r)
+                        {
+                            const Pack factor = a[r][k] * inverse;
+                            for (std::size_t c = k + 1; c < N; ++c) {a[r][c] -= factor * a[k][c];}
+                            b[r] -= factor * b[k];
+                        }
+                    }
+
+                    std::array<Pack,N> x;
+                    for (std::size_t k = N; k-- > 0;)
+                    {
+                        Pack sum = b[k];
+                        for (std::size_t c = k + 1; c < N; ++c) {sum -= a[k][c] * x[c];}
+                        x[k] = sum / a[k][k];
+                    }
+                    return x;
+                }
+
+                // iterates one pack of problems until every lane has stopped, the status and the iteration count of lane i are written to status[i] and iterations[i]
+                template <typename ... Us, typename J, typename Params>
+                void SolvePack(const J &jacobian, std::array<Pack,N> &x, const Params &params, const NewtonSettings &settings, NewtonStatus *status, std::uint32_t *iterations) const
+                {
+                    Mask active = (Pack{} == Pack{});
+                    std::fill_n(status,W,NewtonStatus::MaxIterations);
+                    std::fill_n(iterations,W,static_cast<std::uint32_t>(settings.maxIterations));
+
+                    for (std::size_t it = 0; it < settings.maxIterations && any(active); ++it)
+                    {
+                        const auto args = std::tuple_cat([&]<std::size_t ... Is>(std::index_sequence<Is...>)
+                        {
+                            return std::make_tuple(batch::Lane<Us>{x[Is]}...);
+                        }(std::make_index_sequence<N>{}),params);
+                        const auto at = [&](const auto &expr) {return to_pack(std::apply(expr,args));};
+
+                        std::array<Pack,N> f;
+                        std::array<std::array<Pack,N>,N> a;
+                        [&]<std::size_t ... Is>(std::index_sequence<Is...>)
+                        {
+                            ((f[Is] = at(std::get<Is>(m_equations))), ...);
+                        }(std::make_index_sequence<N>{});
+                        [&]<std::size_t ... Is>(std::index_sequence<Is...>)
+                        {
+                            ((a[Is / N][Is % N] = at(std::get<Is>(jacobian))), ...);
+                        }(std::make_index_sequence<N * N>{});
+
+                        Mask singular = (Pack{} != Pack{});
+                        const std::array<Pack,N> dx = LinearSolve(a,f,singular);
+
+                        Mask overflow = (Pack{} != Pack{});
+                        Mask converged = (Pack{} == Pack{});
+                        std::array<Pack,N> next;
+                        for (std::size_t j = 0; j < N; ++j)
+                        {
+                            next[j] = x[j] - dx[j];
+                            overflow |= ~finite(next[j]);
+                            converged &= (abs(dx[j]) <= settings.absoluteTolerance + settings.relativeTolerance * abs(next[j]));
+                        }
+
+                        const Mask step = active & ~singular & ~overflow;
+                        for (std::size_t j = 0; j < N; ++j) {x[j] = step ? next[j] : x[j];}
+
+                        const Mask stopped = active & (singular | overflow | converged);
+                        for (std::size_t i = 0; i < W; ++i)
+                        {
+                            if (!stopped[i]) {continue;}
+                            status[i] = singular[i] ? NewtonStatus::Singular : overflow[i] ? NewtonStatus::NotFinite : NewtonStatus::Converged;
+                            iterations[i] = static_cast<std::uint32_t>(it + 1);
+                        }
+                        active &= ~stopped;
+                    }
+                }
+
+            public:
+                Newton(Fs... equations) : m_equations(std::move(equations)...) {}
+                [[nodiscard]] const std::tuple<Fs...>& Equations() const {return m_equations;}
+
+                // Solves all the problems described by the spans of the unknowns (starting points, overwritten with the roots) and of the parameters, e.g.
+                // solver.Solve(std::tuple(Unknown(x,xs),Unknown(y,ys)),std::tuple(Parameter(v,depths)));
+                template <typename ... Us, typename ... Ps>
+                NewtonResult Solve(std::tuple<Unknown<Us>...> unknowns, std::tuple<Parameter<Ps>...> parameters = {}, const NewtonSettings &settings = {}, ThreadPool &pool = default_pool()) const
+                {
+                    using Variables = detail::TypeList<Us...,Ps...>;
+                    static_assert(sizeof...(Us) == N,"the system needs as many unknowns as equations");
+                    static_assert(detail::unique_t<Variables>::size == Variables::size,"every variable can be given only once");
+                    static_assert([]<typename ... Vs>(detail::TypeList<Vs...>){return (detail::contains_v<Vs,Variables> && ...);}(detail::concat_t<detail::variables_t<Fs>...>{}),
+                        "every variable of the equations needs to be an unknown or a parameter");
+
+                    const std::size_t size = std::get<0>(unknowns).values.size();
+                    [[maybe_unused]] const bool sameSize = std::apply([&](const auto &... u){return ((u.values.size() == size) && ...);},unknowns)
+                        && std::apply([&](const auto &... p){return ((p.values.size() == size) && ...);},parameters);
+                    assert(sameSize);
+
+                    NewtonResult result;
+                    result.status.resize(size);
+                    result.iterations.resize(size);
+                    if (size == 0) {return result;}
+
+                    const auto jacobian = Jacobian<Us...>();
+                    const std::size_t packs = (size + W - 1) / W;
+                    pool.ParallelFor(packs,newton::grain,[&](std::size_t first, std::size_t last, std::size_t)
+                    {
+                        for (std::size_t pack = first; pack < last; ++pack)
+                        {
+                            const std::size_t pos = pack * W;
+                            const std::size_t count = std::min(W,size - pos);
+
+                            std::array<Pack,N> x = std::apply([&](const auto &... u){return std::array<Pack,N>{batch::detail::load_partial(u.values,pos)...};},unknowns);
+                            const auto params = std::apply([&](const auto &... p){return std::make_tuple(batch::Lane<Ps>{batch::detail::load_partial(p.values,pos)}...);},parameters);
+
+                            std::array<NewtonStatus,W> status;
+                            std::array<std::uint32_t,W> iterations;
+                            SolvePack<Us...>(jacobian,x,params,settings,status.data(),iterations.data());
+
+                            [&]<std::size_t ... Is>(std::index_sequence<Is...>)
+                            {
+                                (batch::detail::store(x[Is],std::get<Is>(unknowns).values,pos,count), ...);
+                            }(std::make_index_sequence<N>{});
+                            std::copy_n(status.begin(),count,result.status.begin() + pos);
+                            std::copy_n(iterations.begin(),count,result.iterations.begin() + pos);
+                        }
+                    });
+
+                    for (const NewtonStatus status : result.status) {result.converged += (status == NewtonStatus::Converged);}
+                    return result;
+                }
+        };
+    }
+
+#endif
@@ -0,0 +1,563 @@
+#ifndef Schroedinger_hxx
+    #define Schroedinger_hxx
+
+    #include <algorithm>
+    #include <cassert>
+    #include <cmath>
+    #include <cstdint>
+    #include <iterator>
+    #include <limits>
+    #include <numeric>
+    #include <random>
+    #include <span>
+    #include <stdexcept>
+    #include <tuple>
+    #include <utility>
+    #include <vector>
+
+    #include "Batch.hxx"
+    #include "Constants.hxx"
+    #include "ThreadPool.hxx"
+
+    namespace femto
+    {
+        struct EigenState
+        {
+            double energy; // MeV
+            std::vector<double> wavefunction; // u at the interior grid points, normalised to the integral of u^2 equal to 1
+        };
+
+        // energies [MeV] delimiting a part of the spectrum
+        struct EnergyWindow
+        {
+            double min;
+            double max;
+        };
+
+        struct ShootingSettings
+        {
+            double tolerance = 1e-12; // relative width of the final bisection bracket
+            bool wavefunctions = true;
+        };
+
+        struct LanczosSettings
+        {
+            double tolerance = 1e-10; // relative residual of the Ritz values accepted as eigenvalues
+            std::size_t maxIterations = 1000; // per slice of the spectrum, a slice which does not converge is split in two
+            bool wavefunctions = true;
+        };
+
+        namespace detail
+        {
+            // Eigenvalues of the symmetric tridiagonal matrix with the diagonal d and the off-diagonal e (e[i] couples i and i + 1) by the implicit QL method.
+            // The eigenvalues are left in d, unsorted, and the last components of the normalised eigenvectors are written to last, if it is given.
+            inline void tridiagonal_eigen(std::vector<double> &d, std::vector<double> e, std::vector<double> *last = nullptr)
+            {
+                const int n = static_cast<int>(d.size());
+                e.resize(n,0.);
+                e[n - 1] = 0.;
+                if (last != nullptr)
+                {
+                    last->assign(n,0.);
+                    (*last)[n - 1] = 1.;
+                }
+
+                for (int l = 0; l < n; ++l)
+                {
+                    int iterations = 0;
+                    int m = l;
+                    do
+                    {
+                        for (m = l; m < n - 1; ++m)
+                        {
+                            if (std::abs(e[m]) <= std::numeric_limits<double>::epsilon() * (std::abs(d[m]) + std::abs(d[m + 1]))) {break;}
+                        }
+                        if (m == l) {break;}
+                        if (iterations++ == 60) {break;}
+
+                        double g = (d[l + 1] - d[l]) / (2. * e[l]);
+                        double r = std::hypot(g,1.);
+                        g = d[m] - d[l] + e[l] / (g + std::copysign(r,g));
+                        double s = 1., c = 1., p = 0.;
+                        int i = m - 1;
+                        for (; i >= l; --i)
+                        {
+                            double f = s * e[i];
+                            const double b = c * e[i];
+                            e[i + 1] = r = std::hypot(f,g);
+                            if (r == 0.)
+                            {
+                                d[i + 1] -= p;
+                                e[m] = 0.;
+                                break;
+                            }
+                            s = f / r;
+                            c = g / r;
+                            g = d[i + 1] - p;
+                            r = (d[i] - g) * s + 2. * c * b;
+                            p = s * r;
+                            d[i + 1] = g + p;
+                            g = c * r - b;
+                            if (last != nullptr)
+                            {
+                                f = (*last)[i + 1];
+                                (*last)[i + 1] = s * (*last)[i] + c * f;
+                                (*last)[i] = c * (*last)[i] - s * f;
+                            }
+                        }
+                        if (r == 0. && i >= l) {continue;}
+                        d[l] -= p;
+                        e[l] = g;
+                        e[m] = 0.;
+                    } while (m != l);
+                }
+            }
+        }
+
+        namespace lanczos
+        {
+            // largest number of eigenvalues searched for with one shift, the wider parts of the spectrum are sliced by the inertia
+            inline constexpr std::size_t slice = 8;
+        }
+
+        // Stationary Schroedinger equation -hbar^2 / (2 mass) u'' + (V(r) + hbar^2 l (l + 1) / (2 mass r^2)) u = E u on [min,max] with u(min) = u(max) = 0.
+        // With min = 0 it is the radial equation for u = r R(r), with l = 0 it is also the one-dimensional equation in a box. Energies are in MeV, lengths in fm.
+        // The effective potential is tabulated once on the points min + (i + 1) * step, i = 0,...,points - 1, and both solvers use O(points) memory:
+        // - Shooting integrates the equation with the Numerov method and brackets every eigenvalue by bisection on the number of nodes,
+        // - Lanczos applies the shift-invert Lanczos method to the tridiagonal finite-difference Hamiltonian, which is never stored as a dense matrix. The spectrum is cut
+        //   into slices with few eigenvalues, counted by the inertia of H - e, and a slice is split further until all of its eigenvalues are found.
+        template <typename T>
+        class Schroedinger
+        {
+            private:
+                double m_min;
+                double m_step;
+                double m_scale; // hbar^2 / (2 mass) [MeV fm^2], internally the equation is u'' = (w - e) u with w = V / m_scale and e = E / m_scale
+                double m_lower; // minimum of w, all the eigenvalues lie above it
+                std::vector<double> m_w;
+
+                [[nodiscard]] std::size_t Size() const {return m_w.size();}
+                [[nodiscard]] double Diagonal(std::size_t i) const {return 2. / (m_step * m_step) + m_w[i];}
+                [[nodiscard]] double OffDiagonal() const {return -1. / (m_step * m_step);}
+
+                // scales u to the integral of u^2 equal to 1 and to a positive slope at min
+                void Normalise(std::vector<double> &u) const
+                {
+                    const double norm = std::copysign(std::sqrt(m_step * std::inner_product(u.begin(),u.end(),u.begin(),0.)),u[0]);
+                    std::for_each(u.begin(),u.end(),[&](double &v){v /= norm;});
+                }
+
+                // number of nodes of the solution started at min with energy e, equal to the number of eigenvalues below e; the solution is written to u if it is given
+                std::size_t Numerov(double e, std::vector<double> *u = nullptr) const
+                {
+                    const std::size_t n = Size();
+                    const double h12 = m_step * m_step / 12.;
+                    const auto f = [&](std::size_t i) {return 1. - h12 * (m_w[i] - e);};
+                    constexpr double big = 1e150;
+
+                    // outward: u(min) = 0, the value at max is known up to the positive factor f(max)
+                    std::size_t nodes = 0;
+                    double previous = 0., current = m_step, next = 0.;
+                    if (u != nullptr) {(*u)[0] = current;}
+                    for (std::size_t i = 0; i < n; ++i)
+                    {
+                        next = (12. - 10. * f(i)) * current - ((i > 0) ? f(i - 1) * previous : 0.);
+                        if (i + 1 < n) {next /= f(i + 1);}
+                        nodes += (next < 0.) != (current < 0.);
+
+                        previous = current;
+                        current = next;
+                        if (std::abs(current) > big)
+                        {
+                            previous /= big;
+                            current /= big;
+                        }
+                    }
+                    if (u == nullptr) {return nodes;}
+
+                    // the outward solution is unstable in the classically forbidden region near max, so it is matched there with the inward one
+                    std::size_t match = n - 2;
+                    while (match > 1 && m_w[match] - e > 0.) {--match;}
+                    std::vector<double> &values = *u;
+                    values[1] = ((12. - 10. * f(0)) * values[0]) / f(1);
+                    for (std::size_t i = 1; i < match; ++i)
+                    {
+                        values[i + 1] = ((12. - 10. * f(i)) * values[i] - f(i - 1) * values[i - 1]) / f(i + 1);
+                        if (std::abs(values[i + 1]) > big)
+                        {
+                            std::for_each(values.begin(),values.begin() + i + 2,[&](double &v){v /= big;});
+                        }
+                    }
+                    const double outward = values[match];
+
+                    values[n - 1] = m_step;
+                    values[n - 2] = ((12. - 10. * f(n - 1)) * values[n - 1]) / f(n - 2);
+                    for (std::size_t i = n - 2; i > match; --i)
+                    {
+                        values[i - 1] = ((12. - 10. * f(i)) * values[i] - f(i + 1) * values[i + 1]) / f(i - 1);
+                        if (std::abs(values[i - 1]) > big)
+                        {
+                            std::for_each(values.begin() + i - 1,values.end(),[&](double &v){v /= big;});
+                        }
+                    }
+                    const double ratio = outward / values[match];
+                    std::for_each(values.begin() + match,values.end(),[&](double &v){v *= ratio;});
+                    return nodes;
+                }
+
+                // i-th eigenvalue (counted from 0) of the Numerov discretisation, bisected on the number of nodes
+                [[nodiscard]] double Bisect(std::size_t index, double tolerance) const
+                {
+                    const double length = m_step * static_cast<double>(Size() + 1);
+                    double lo = m_lower, step = 1. / (length * length);
+                    double hi = lo + step;
+                    for (std::size_t it = 0; it < 2000 && Numerov(hi) <= index; ++it)
+                    {
+                        lo = hi;
+                        step *= 2.;
+                        hi = lo + step;
+                    }
+                    for (std::size_t it = 0; it < 200 && hi - lo > tolerance * (std::abs(lo) + std::abs(hi)); ++it)
+                    {
+                        const double mid = 0.5 * (lo + hi);
+                        (Numerov(mid) > index ? hi : lo) = mid;
+                    }
+                    return 0.5 * (lo + hi);
+                }
+
+                // pivots of the LDL^T factorisation of H - shift, a zero pivot is replaced by a tiny one
+                void Factorise(double shift, std::vector<double> &pivots) const
+                {
+                    const double e2 = OffDiagonal() * OffDiagonal();
+                    const double tiny = std::numeric_limits<double>::epsilon() * 4. / (m_step * m_step);
+                    pivots.resize(Size());
+                    for (std::size_t i = 0; i < Size(); ++i)
+                    {
+                        double p = Diagonal(i) - shift - ((i > 0) ? e2 / pivots[i - 1] : 0.);
+                        if (p == 0.) {p = tiny;}
+                        pivots[i] = p;
+                    }
+                }
+
+                // x = (H - shift)^-1 b from the pivots of Factorise, x and b may be the same vector
+                void Solve(const std::vector<double> &pivots, std::vector<double> &x, const std::vector<double> &b) const
+                {
+                    const std::size_t n = Size();
+                    const double e = OffDiagonal();
+                    x[0] = b[0];
+                    for (std::size_t i = 1; i < n; ++i) {x[i] = b[i] - e / pivots[i - 1] * x[i - 1];}
+                    x[n - 1] /= pivots[n - 1];
+                    for (std::size_t i = n - 1; i-- > 0;) {x[i] = x[i] / pivots[i] - e / pivots[i] * x[i + 1];}
+                }
+
+                // number of finite-difference eigenvalues below e (Sylvester's law of inertia)
+                [[nodiscard]] std::size_t Inertia(double e) const
+                {
+                    std::vector<double> pivots;
+                    Factorise(e,pivots);
+                    return static_cast<std::size_t>(std::count_if(pivots.begin(),pivots.end(),[](double p){return p < 0.;}));
+                }
+
+                // inverse iteration at the approximate eigenvalue e, returns the Rayleigh quotient and the norm of the residual H x - quotient x, and leaves the normalised eigenvector in x
+                std::pair<double,double> Refine(double e, std::vector<double> &x, std::mt19937_64 &rng) const
+                {
+                    const std::size_t n = Size();
+                    std::uniform_real_distribution<double> uniform(-1.,1.);
+                    std::vector<double> pivots;
+                    Factorise(e,pivots);
+                    x.resize(n);
+                    std::generate(x.begin(),x.end(),[&]{return uniform(rng);});
+                    for (std::size_t it = 0; it < 3; ++it)
+                    {
+                        Solve(pivots,x,x);
+                        const double norm = std::sqrt(std::inner_product(x.begin(),x.end(),x.begin(),0.));
+                        std::for_each(x.begin(),x.end(),[&](double &v){v /= norm;});
+                    }
+
+                    const double off = OffDiagonal();
+                    const auto product = [&](std::size_t i) {return Diagonal(i) * x[i] + off * (((i > 0) ? x[i - 1] : 0.) + ((i + 1 < n) ? x[i + 1] : 0.));};
+                    double rayleigh = 0.;
+                    for (std::size_t i = 0; i < n; ++i) {rayleigh += x[i] * product(i);}
+                    double residual = 0.;
+                    for (std::size_t i = 0; i < n; ++i) {residual += (product(i) - rayleigh * x[i]) * (product(i) - rayleigh * x[i]);}
+                    return {rayleigh,std::sqrt(residual)};
+                }
+
+                // resolution of the eigenvalues near e, set by the rounding of H
+                [[nodiscard]] double Noise(double e) const {return 1e3 * std::numeric_limits<double>::epsilon() * (4. / (m_step * m_step) + std::abs(e));}
+
+                // e moved in steps in the direction dir (+1 or -1) until no eigenvalue lies within 2 noise of it
+                [[nodiscard]] double Separate(double e, double dir) const
+                {
+                    while (Inertia(e - 2. * Noise(e)) != Inertia(e + 2. * Noise(e))) {e += dir * 4. * Noise(e);}
+                    return e;
+                }
+
+                // point inside (lo,hi) with no eigenvalue within 2 noise of it, tried at the middle first and then further out; there are expected eigenvalues in the interval,
+                // so one of the 2 expected + 3 points is free unless the eigenvalues are closer than the noise. Returns NaN if none is free.
+                [[nodiscard]] double Split(double lo, double hi, std::size_t expected) const
+                {
+                    const double middle = 0.5 * (lo + hi), step = (hi - lo) / (2. * static_cast<double>(expected + 2));
+                    for (std::size_t j = 0; j < 2 * expected + 3; ++j)
+                    {
+                        const double e = middle + ((j % 2 == 0) ? 1. : -1.) * static_cast<double>((j + 1) / 2) * step;
+                        const double gap = 2. * Noise(e);
+                        if (e - gap > lo && e + gap < hi && Inertia(e - gap) == Inertia(e + gap)) {return e;}
+                    }
+                    return std::numeric_limits<double>::quiet_NaN();
+                }
+
+                // eigenvalues of the Lanczos matrix which approximate the eigenvalues of the operator: converged and not spurious in the sense of Cullum and Willoughby
+                [[nodiscard]] static std::vector<double> Ritz(const std::vector<double> &alpha, const std::vector<double> &beta, double tolerance)
+                {
+                    const std::size_t m = alpha.size();
+                    std::vector<double> theta = alpha, last;
+                    detail::tridiagonal_eigen(theta,std::vector<double>(beta.begin(),beta.begin() + (m - 1)),&last);
+
+                    std::vector<double> reduced(alpha.begin() + 1,alpha.end());
+                    if (m > 1) {detail::tridiagonal_eigen(reduced,std::vector<double>(beta.begin() + 1,beta.begin() + (m - 1)));}
+
+                    double norm = 0.;
+                    for (const double t : theta) {norm = std::max(norm,std::abs(t));}
+                    const double delta = 1e3 * std::numeric_limits<double>::epsilon() * norm;
+
+                    std::vector<double> accepted;
+                    for (std::size_t i = 0; i < m; ++i)
+                    {
+                        if (beta[m - 1] * std::abs(last[i]) > tolerance * std::abs(theta[i])) {continue;}
+                        const auto close = [&](double t){return std::abs(t - theta[i]) <= delta;};
+                        const bool simple = std::count_if(theta.begin(),theta.end(),close) == 1;
+                        if (simple && std::any_of(reduced.begin(),reduced.end(),close)) {continue;}
+                        accepted.push_back(theta[i]);
+                    }
+                    return accepted;
+                }
+
+                // finite-difference eigenpairs with e in [lo,hi), found by the Lanczos method applied to (H - shift)^-1, shift being the middle of the slice;
+                // at most expected of them, each with a residual below the noise, fewer if the method has not converged
+                [[nodiscard]] std::vector<EigenState> Slice(double lo, double hi, std::size_t expected, std::uint64_t seed, const LanczosSettings &settings) const
+                {
+                    std::vector<EigenState> states;
+
+                    const std::size_t n = Size();
+                    const double shift = 0.5 * (lo + hi);
+                    std::vector<double> pivots;
+                    Factorise(shift,pivots);
+
+                    std::mt19937_64 rng(seed);
+                    std::uniform_real_distribution<double> uniform(-1.,1.);
+                    std::vector<double> q(n), previous(n,0.), w(n);
+                    std::generate(q.begin(),q.end(),[&]{return uniform(rng);});
+                    const double norm = std::sqrt(std::inner_product(q.begin(),q.end(),q.begin(),0.));
+                    std::for_each(q.begin(),q.end(),[&](double &v){v /= norm;});
+
+                    // only the three latest Lanczos vectors are kept, the eigenvectors are recovered by inverse iteration
+                    std::vector<double> alpha, beta;
+                    for (std::size_t j = 0; j < std::min(settings.maxIterations,n); ++j)
+                    {
+                        Solve(pivots,w,q);
+                        const double a = std::inner_product(q.begin(),q.end(),w.begin(),0.);
+                        const double b = beta.empty() ? 0. : beta.back();
+                        for (std::size_t i = 0; i < n; ++i) {w[i] -= a * q[i] + b * previous[i];}
+                        alpha.push_back(a);
+                        beta.push_back(std::sqrt(std::inner_product(w.begin(),w.end(),w.begin(),0.)));
+
+                        const bool exhausted = beta.back() <= std::numeric_limits<double>::epsilon() * std::abs(a) || j + 1 == std::min(settings.maxIterations,n);
+                        std::swap(previous,q);
+                        if (!exhausted)
+                        {
+                            for (std::size_t i = 0; i < n; ++i) {q[i] = w[i] / beta.back();}
+                        }
+                        if (alpha.size() < expected || (alpha.size() % 10 != 0 && !exhausted)) {continue;}
+
+                        std::vector<double> candidates;
+                        for (const double theta : Ritz(alpha,beta,settings.tolerance))
+                        {
+                            const double e = shift + 1. / theta;
+                            if (e >= lo && e <= hi) {candidates.push_back(e);}
+                        }
+                        std::sort(candidates.begin(),candidates.end());
+                        candidates.erase(std::unique(candidates.begin(),candidates.end(),[&](double x, double y){return y - x <= settings.tolerance * (std::abs(x) + std::abs(y));}),candidates.end());
+                        if (candidates.size() < expected && !exhausted) {continue;}
+
+                        // ghost copies of an eigenvalue converge to the same state, which is resolved up to the rounding of H; a candidate between two eigenvalues
+                        // leaves a mixture of their vectors with a large residual and is dropped
+                        states.clear();
+                        const double noise = Noise(shift);
+                        for (const double candidate : candidates)
+                        {
+                            std::vector<double> vector;
+                            const auto [e,residual] = Refine(candidate,vector,rng);
+                            if (e >= lo && e < hi && residual <= noise) {states.push_back({e,settings.wavefunctions ? std::move(vector) : std::vector<double>{}});}
+                        }
+                        std::sort(states.begin(),states.end(),[](const EigenState &x, const EigenState &y){return x.energy < y.energy;});
+                        states.erase(std::unique(states.begin(),states.end(),[&](const EigenState &x, const EigenState &y){return y.energy - x.energy <= 2. * noise;}),states.end());
+                        if (states.size() >= expected || exhausted) {break;}
+                    }
+                    return states;
+                }
+
+                // Appends the eigenpairs with e in [lo,hi) to states, below being the number of eigenvalues below lo and above the number below hi. No eigenvalue may lie
+                // within the noise of lo or hi, then the inertia tells the number of eigenvalues of every slice, and a slice which yields fewer of them is split in two.
+                void Slices(double lo, double hi, std::size_t below, std::size_t above, std::uint64_t seed, const LanczosSettings &settings, std::vector<EigenState> &states) const
+                {
+                    const std::size_t expected = above - below;
+                    if (expected == 0) {return;}
+                    if (expected <= lanczos::slice)
+                    {
+                        std::vector<EigenState> found = Slice(lo,hi,expected,seed,settings);
+                        if (found.size() == expected)
+                        {
+                            std::move(found.begin(),found.end(),std::back_inserter(states));
+                            return;
+                        }
+                    }
+
+                    const double split = Split(lo,hi,expected);
+                    if (std::isnan(split)) {throw std::runtime_error("femto::Schroedinger::Lanczos: the eigenvalues are not resolved, they lie closer than the rounding of the Hamiltonian");}
+                    const std::size_t middle = Inertia(split);
+                    Slices(lo,split,below,middle,2 * seed + 1,settings,states);
+                    Slices(split,hi,middle,above,2 * seed + 2,settings,states);
+                }
+
+                // the finite-difference eigenpairs with first <= index < last in the order of the energies, all of them with e in [lo,hi]
+                [[nodiscard]] std::vector<EigenState> Window(double lo, double hi, std::size_t first, std::size_t last, std::uint64_t seed, const LanczosSettings &settings) const
+                {
+                    if (last <= first) {return {};}
+
+                    // the ends are moved away from the eigenvalues, so that every eigenvalue falls into one slice and its index follows from the inertia
+                    lo = Separate(lo,-1.);
+                    hi = Separate(hi,1.);
+                    const std::size_t below = Inertia(lo);
+                    std::vector<EigenState> states;
+                    Slices(lo,hi,below,Inertia(hi),seed,settings,states);
+                    std::sort(states.begin(),states.end(),[](const EigenState &x, const EigenState &y){return x.energy < y.energy;});
+
+                    states.erase(states.begin() + (last - below),states.end());
+                    states.erase(states.begin(),states.begin() + (first - below));
+                    for (EigenState &state : states)
+                    {
+                        state.energy *= m_scale;
+                        if (!state.wavefunction.empty()) {Normalise(state.wavefunction);}
+                    }
+                    return states;
+                }
+
+                // state with the given number of nodes of the Numerov discretisation
+                [[nodiscard]] EigenState Shoot(std::size_t index, const ShootingSettings &settings) const
+                {
+                    const double e = Bisect(index,settings.tolerance);
+                    EigenState state{e * m_scale,{}};
+                    if (settings.wavefunctions)
+                    {
+                        state.wavefunction.resize(Size());
+                        Numerov(e,&state.wavefunction);
+                        Normalise(state.wavefunction);
+                    }
+                    return state;
+                }
+
+            public:
+                // potential is a function of the variable T [MeV], mass is the (reduced) mass [MeV], l the orbital angular momentum
+                template <typename F>
+                Schroedinger(const F &potential, Variable<T>, double min, double max, std::size_t points, double mass, unsigned l = 0, ThreadPool &pool = default_pool())
+                    : m_min(min), m_step((max - min) / static_cast<double>(points + 1)), m_scale(constants::hbarcMeVfm() * constants::hbarcMeVfm() / (2. * mass)), m_w(points)
+                {
+                    assert(points >= 3 && max > min);
+                    std::vector<double> positions(points);
+                    for (std::size_t i = 0; i < points; ++i) {positions[i] = Position(i);}
+
+                    pool.ParallelFor(points,4096,[&](std::size_t begin, std::size_t end, std::size_t)
+                    {
+                        std::span<double> out(m_w.data() + begin,end - begin);
+                        evaluate<T>(potential,out,std::span<const double>(positions.data() + begin,end - begin));
+                        for (std::size_t i = begin; i < end; ++i)
+                        {
+                            m_w[i] = m_w[i] / m_scale + ((l > 0) ? l * (l + 1.) / (positions[i] * positions[i]) : 0.);
+                        }
+                    });
+                    m_lower = *std::min_element(m_w.begin(),m_w.end());
+                    m_lower -= 1e-6 * (1. + std::abs(m_lower));
+                }
+
+                [[nodiscard]] std::size_t Points() const {return Size();}
+                [[nodiscard]] double Step() const {return m_step;}
+                [[nodiscard]] double Position(std::size_t i) const {return m_min + static_cast<double>(i + 1) * m_step;}
+                // number of finite-difference eigenvalues below energy [MeV]
+                [[nodiscard]] std::size_t Count(double energy) const {return Inertia(energy / m_scale);}
+
+                // the count lowest states, each bisected in its own task
+                [[nodiscard]] std::vector<EigenState> Shooting(std::size_t count, const ShootingSettings &settings = {}, ThreadPool &pool = default_pool()) const
+                {
+                    std::vector<EigenState> states(std::min(count,Size()));
+                    pool.ParallelFor(states.size(),1,[&](std::size_t begin, std::size_t end, std::size_t)
+                    {
+                        for (std::size_t i = begin; i < end; ++i) {states[i] = Shoot(i,settings);}
+                    });
+                    return states;
+                }
+
+                // all the states in each of the windows, every state is bisected in its own task
+                [[nodiscard]] std::vector<std::vector<EigenState> > Shooting(std::span<const EnergyWindow> windows, const ShootingSettings &settings = {}, ThreadPool &pool = default_pool()) const
+                {
+                    std::vector<std::vector<EigenState> > states(windows.size());
+                    std::vector<std::tuple<std::size_t,std::size_t,std::size_t> > tasks; // (window, position in the window, index of the state)
+                    for (std::size_t w = 0; w < windows.size(); ++w)
+                    {
+                        const std::size_t first = Numerov(windows[w].min / m_scale), last = Numerov(windows[w].max / m_scale);
+                        for (std::size_t i = first; i < last; ++i) {tasks.emplace_back(w,i - first,i);}
+                        states[w].resize(last - std::min(first,last));
+                    }
+                    pool.ParallelFor(tasks.size(),1,[&](std::size_t begin, std::size_t end, std::size_t)
+                    {
+                        for (std::size_t t = begin; t < end; ++t)
+                        {
+                            const auto [w,slot,i] = tasks[t];
+                            states[w][slot] = Shoot(i,settings);
+                        }
+                    });
+                    return states;
+                }
+
+                // The count lowest finite-difference states. Throws std::runtime_error if some of them cannot be resolved from each other.
+                [[nodiscard]] std::vector<EigenState> Lanczos(std::size_t count, const LanczosSettings &settings = {}) const
+                {
+                    count = std::min(count,Size());
+                    if (count == 0) {return {};}
+
+                    // upper end of the window, which encloses exactly count eigenvalues: lo has fewer below it, hi at least count
+                    const double length = m_step * static_cast<double>(Size() + 1);
+                    double lo = m_lower, step = 1. / (length * length);
+                    double hi = lo + step;
+                    while (Inertia(hi) < count)
+                    {
+                        lo = hi;
+                        step *= 2.;
+                        hi = lo + step;
+                    }
+                    for (std::size_t it = 0; it < 200 && Inertia(hi) > count; ++it)
+                    {
+                        const double mid = 0.5 * (lo + hi);
+                        (Inertia(mid) < count ? lo : hi) = mid;
+                    }
+                    return Window(m_lower,hi,0,count,0,settings);
+                }
+
+                // All the finite-difference states in each of the windows, the windows are processed in parallel. Throws std::runtime_error if some of them cannot be resolved from each other.
+                [[nodiscard]] std::vector<std::vector<EigenState> > Lanczos(std::span<const EnergyWindow> windows, const LanczosSettings &settings = {}, ThreadPool &pool = default_pool()) const
+                {
+                    std::vector<std::vector<EigenState> > states(windows.size());
+                    pool.ParallelFor(windows.size(),1,[&](std::size_t begin, std::size_t end, std::size_t)
+                    {
+                        for (std::size_t w = begin; w < end; ++w)
+                        {
+                            const double lo = windows[w].min / m_scale, hi = windows[w].max / m_scale;
+                            states[w] = Window(lo,hi,Inertia(lo),Inertia(hi),w,settings);
+                        }
+                    });
+                    return states;
+                }
+        };
+    }
+
+#endif
@@ -0,0 +1,563 @@
+#ifndef Simplify_hxx
+    #define Simplify_hxx
+
+    #include <array>
+    #include <cstdint>
+    #include <limits>
+
+    #include "Expressions.hxx"
+
+    namespace femto
+    {
+        namespace detail
+        {
+            template <typename T>
+            struct IsLiteral : std::false_type {};
+
+            template <int V>
+            struct IsLiteral<Literal<V> > : std::true_type {};
+
+            template <typename T>
+            inline constexpr bool is_literal_v = IsLiteral<T>::value;
+
+            template <typename T, int V>
+            inline constexpr bool is_literal_of_v = std::is_same_v<T,Literal<V> >;
+
+            // nodes whose value does not depend on the variables
+            template <typename T>
+            struct IsConstant : IsLiteral<T> {};
+
+            template <typename T>
+            struct IsConstant<Constant<T> > : std::true_type {};
+
+            template <typename T>
+            inline constexpr bool is_constant_v = IsConstant<T>::value;
+
+            // nodes which are fully described by their type, i.e. two objects of such type always have the same value
+            template <typename T>
+            struct IsStateless : IsLiteral<T> {};
+
+            template <typename T>
+            struct IsStateless<Variable<T> > : std::true_type {};
+
+            template <typename T, typename U, typename Op>
+            struct IsStateless<BinaryOp<T,U,Op> > : std::bool_constant<IsStateless<T>::value && IsStateless<U>::value> {};
+
+            template <typename T, typename Op>
+            struct IsStateless<UnaryOp<T,Op> > : IsStateless<T> {};
+
+            template <typename T>
+            inline constexpr bool is_stateless_v = IsStateless<T>::value;
+
+            // nodes which are fully described by their type and the values of their constants, which need to be exact as double (see SharingPlan)
+            template <typename T>
+            struct IsShareable : IsStateless<T> {};
+
+            template <typename T>
+            struct IsShareable<Constant<T> > : std::bool_constant<Scalar<T> && std::numeric_limits<T>::digits <= std::numeric_limits<double>::digits> {};
+
+            template <typename T, typename U, typename Op>
+            struct IsShareable<BinaryOp<T,U,Op> > : std::bool_constant<IsShareable<T>::value && IsShareable<U>::value> {};
+
+            template <typename T, typename Op>
+            struct IsShareable<UnaryOp<T,Op> > : IsShareable<T> {};
+
+            template <typename T>
+            inline constexpr bool is_shareable_v = IsShareable<T>::value;
+
+            template <typename T>
+            struct NodeTraits
+            {
+                static constexpr bool isBinary = false;
+                static constexpr bool isUnary = false;
+                using Operation = void;
+            };
+
+            template <typename T, typename U, typename Op>
+            struct NodeTraits<BinaryOp<T,U,Op> >
+            {
+                static constexpr bool isBinary = true;
+                static constexpr bool isUnary = false;
+                using Operation = Op;
+            };
+
+            template <typename T, typename Op>
+            struct NodeTraits<UnaryOp<T,Op> >
+            {
+                static constexpr bool isBinary = false;
+                static constexpr bool isUnary = true;
+                using Operation = Op;
+            };
+
+            template <typename T>
+            struct IsFunction : std::false_type {};
+
+            template <typename T>
+            struct IsFunction<Function<T> > : std::true_type {};
+
+            template <typename T>
+            struct IsDerivative : std::false_type {};
+
+            template <typename T, typename U>
+            struct IsDerivative<Derivative<T,U> > : std::true_type {};
+
+            // rewrite rules, the arguments are already simplified
+            template <typename T>
+            [[nodiscard]] constexpr auto fold(UnaryOperations::Negation, const T &arg)
+            {
+                if constexpr (is_literal_v<T>)
+                {
+                    return Literal<-T::value>{};
+                }
+                else if constexpr (is_constant_v<T>)
+                {
+                    return Constant(-arg());
+                }
+                else if constexpr (std::is_same_v<typename NodeTraits<T>::Operation,UnaryOperations::Negation>)
+                {
+                    return arg.Arg(); // -(-a) = a
+                }
+                else
+                {
+                    return UnaryOp<T,UnaryOperations::Negation>(arg);
+                }
+            }
+
+            template <typename T>
+            [[nodiscard]] constexpr auto fold(UnaryOperations::Exponential, const T &arg)
+            {
+                if constexpr (is_literal_of_v<T,0>)
+                {
+                    return Literal<1>{};
+                }
+                else if constexpr (is_constant_v<T>)
+                {
+                    return Constant(math::exp(static_cast<double>(arg())));
+                }
+                else
+                {
+                    return UnaryOp<T,UnaryOperations::Exponential>(arg);
+                }
+            }
+
+            template <typename T>
+            [[nodiscard]] constexpr auto fold(UnaryOperations::NaturalLog, const T &arg)
+            {
+                if constexpr (is_literal_of_v<T,1>)
+                {
+                    return Literal<0>{};
+                }
+                else if constexpr (is_constant_v<T>)
+                {
+                    return Constant(math::ln(static_cast<double>(arg())));
+                }
+                else
+                {
+                    return UnaryOp<T,UnaryOperations::NaturalLog>(arg);
+                }
+            }
+
+            template <typename T>
+            [[nodiscard]] constexpr auto fold(UnaryOperations::SquareRoot, const T &arg)
+            {
+                if constexpr (is_literal_of_v<T,0> || is_literal_of_v<T,1>)
+                {
+                    return arg;
+                }
+                else if constexpr (is_constant_v<T>)
+                {
+                    return Constant(math::sqrt(static_cast<double>(arg())));
+                }
+                else
+                {
+                    return UnaryOp<T,UnaryOperations::SquareRoot>(arg);
+                }
+            }
+
+            template <typename T, typename U>
+            [[nodiscard]] constexpr auto fold(BinaryOperations::Sum, const T &lhs, const U &rhs)
+            {
+                if constexpr (is_literal_v<T> && is_literal_v<U>)
+                {
+                    return Literal<T::value + U::value>{};
+                }
+                else if constexpr (is_literal_of_v<T,0>)
+                {
+                    return rhs;
+                }
+                else if constexpr (is_literal_of_v<U,0>)
+                {
+                    return lhs;
+                }
+                else if constexpr (is_constant_v<T> && is_constant_v<U>)
+                {
+                    return Constant(lhs() + rhs());
+                }
+                else if constexpr (std::is_same_v<T,U> && is_stateless_v<T>)
+                {
+                    return BinaryOp<Literal<2>,T,BinaryOperations::Multiplication>(Literal<2>{},lhs); // a + a = 2 * a
+                }
+                else
+                {
+                    return BinaryOp<T,U,BinaryOperations::Sum>(lhs,rhs);
+                }
+            }
+
+            template <typename T, typename U>
+            [[nodiscard]] constexpr auto fold(BinaryOperations::Difference, const T &lhs, const U &rhs)
+            {
+                if constexpr (is_literal_v<T> && is_literal_v<U>)
+                {
+                    return Literal<T::value - U::value>{};
+                }
+                else if constexpr (is_literal_of_v<U,0>)
+                {
+                    return lhs;
+                }
+                else if constexpr (is_literal_of_v<T,0>)
+                {
+                    return fold(UnaryOperations::Negation{},rhs);
+                }
+                else if constexpr (is_constant_v<T> && is_constant_v<U>)
+                {
+                    return Constant(lhs() - rhs());
+                }
+                else if constexpr (std::is_same_v<T,U> && is_stateless_v<T>)
+                {
+                    return Literal<0>{}; // a - a = 0
+                }
+                else
+                {
+                    return BinaryOp<T,U,BinaryOperations::Difference>(lhs,rhs);
+                }
+            }
+
+            template <typename T, typename U>
+            [[nodiscard]] constexpr auto fold(BinaryOperations::Multiplication, const T &lhs, const U &rhs)
+            {
+                if constexpr (is_literal_v<T> && is_literal_v<U>)
+                {
+                    return Literal<T::value * U::value>{};
+                }
+                else if constexpr (is_literal_of_v<T,0> || is_literal_of_v<U,0>)
+                {
+                    return Literal<0>{};
+                }
+                else if constexpr (is_literal_of_v<T,1>)
+                {
+                    return rhs;
+                }
+                else if constexpr (is_literal_of_v<U,1>)
+                {
+                    return lhs;
+                }
+                else if constexpr (is_literal_of_v<T,-1>)
+                {
+                    return fold(UnaryOperations::Negation{},rhs);
+                }
+                else if constexpr (is_literal_of_v<U,-1>)
+                {
+                    return fold(UnaryOperations::Negation{},lhs);
+                }
+                else if constexpr (is_constant_v<T> && is_constant_v<U>)
+                {
+                    return Constant(lhs() * rhs());
+                }
+                else if constexpr (is_constant_v<U>)
+                {
+                    return fold(BinaryOperations::Multiplication{},rhs,lhs); // constant factors are kept on the left
+                }
+                else if constexpr (is_constant_v<T> && std::is_same_v<typename NodeTraits<U>::Operation,BinaryOperations::Multiplication>)
+                {
+                    if constexpr (is_constant_v<std::remove_cvref_t<decltype(rhs.Lhs())> >)
+                    {
+                        // a * (b * c) = (a * b) * c, where a and b are constants
+                        return fold(BinaryOperations::Multiplication{},fold(BinaryOperations::Multiplication{},lhs,rhs.Lhs()),rhs.Rhs());
+                    }
+                    else
+                    {
+                        return BinaryOp<T,U,BinaryOperations::Multiplication>(lhs,rhs);
+                    }
+                }
+                else
+                {
+                    return BinaryOp<T,U,BinaryOperations::Multiplication>(lhs,rhs);
+                }
+            }
+
+            template <typename T, typename U>
+            [[nodiscard]] constexpr auto fold(BinaryOperations::Division, const T &lhs, const U &rhs)
+            {
+                if constexpr (is_literal_of_v<T,0>)
+                {
+                    return Literal<0>{};
+                }
+                else if constexpr (is_literal_of_v<U,1>)
+                {
+                    return lhs;
+                }
+                else if constexpr (is_constant_v<T> && is_constant_v<U>)
+                {
+                    return Constant(static_cast<double>(lhs()) / rhs());
+                }
+                else
+                {
+                    return BinaryOp<T,U,BinaryOperations::Division>(lhs,rhs);
+                }
+            }
+
+            template <typename T, typename U>
+            [[nodiscard]] constexpr auto fold(BinaryOperations::Power, const T &base, const U &exponent)
+            {
+                if constexpr (is_literal_of_v<U,0> || is_literal_of_v<T,1>)
+                {
+                    return Literal<1>{};
+                }
+                else if constexpr (is_literal_of_v<U,1>)
+                {
+                    return base;
+                }
+                else if constexpr (is_constant_v<T> && is_constant_v<U>)
+                {
+                    return Constant(math::pow(static_cast<double>(base()),exponent()));
+                }
+                else
+                {
+                    return BinaryOp<T,U,BinaryOperations::Power>(base,exponent);
+                }
+            }
+
+            // distinct address for every type, which identifies the node types at run time
+            template <typename T>
+            inline constexpr char type_tag = 0;
+
+            // number of shareable BinaryOp and UnaryOp nodes of the tree
+            template <typename T>
+            struct SubtreeCount : std::integral_constant<std::size_t,0> {};
+
+            template <typename T, typename U, typename Op>
+            struct SubtreeCount<BinaryOp<T,U,Op> > : std::integral_constant<std::size_t,std::size_t(is_shareable_v<BinaryOp<T,U,Op> >) + SubtreeCount<T>::value + SubtreeCount<U>::value> {};
+
+            template <typename T, typename Op>
+            struct SubtreeCount<UnaryOp<T,Op> > : std::integral_constant<std::size_t,std::size_t(is_shareable_v<UnaryOp<T,Op> >) + SubtreeCount<T>::value> {};
+
+            // Constant leaves whose values tell the shareable subtrees of one type apart
+            template <typename T>
+            inline constexpr bool is_key_v = is_constant_v<T> && !is_literal_v<T> && is_shareable_v<T>;
+
+            // number of such leaves of the tree
+            template <typename T>
+            struct ConstantCount : std::integral_constant<std::size_t,std::size_t(is_key_v<T>)> {};
+
+            template <typename T, typename U, typename Op>
+            struct ConstantCount<BinaryOp<T,U,Op> > : std::integral_constant<std::size_t,ConstantCount<T>::value + ConstantCount<U>::value> {};
+
+            template <typename T, typename Op>
+            struct ConstantCount<UnaryOp<T,Op> > : ConstantCount<T> {};
+
+            // values of the constants of the tree in pre-order, so the constants of every subtree form a contiguous range
+            template <typename T>
+            constexpr void gather_constants(const T &expr, double *&out)
+            {
+                if constexpr (NodeTraits<T>::isBinary)
+                {
+                    gather_constants(expr.Lhs(),out);
+                    gather_constants(expr.Rhs(),out);
+                }
+                else if constexpr (NodeTraits<T>::isUnary)
+                {
+                    gather_constants(expr.Arg(),out);
+                }
+                else if constexpr (is_key_v<T>)
+                {
+                    *out++ = static_cast<double>(expr());
+                }
+            }
+
+            // Which shareable subtrees of T are equal, i.e. have the same type and the same constants. The shareable nodes are numbered in the order in
+            // which the evaluation reaches them: the first of a repeated subtree stores its value in slots[k], the later ones (reused[k]) read it and
+            // are not descended into. Found once per expression, in O(N) per node for N nodes.
+            template <typename T>
+            struct SharingPlan
+            {
+                static constexpr std::size_t nodes = SubtreeCount<T>::value;
+                static constexpr std::uint32_t none = std::numeric_limits<std::uint32_t>::max();
+
+                std::array<std::uint32_t,nodes> slots{};
+                std::array<bool,nodes> reused{};
+                std::size_t size = 0; // number of slots
+
+                explicit constexpr SharingPlan(const T &expr)
+                {
+                    std::array<double,ConstantCount<T>::value> values{};
+                    double *out = values.data();
+                    gather_constants(expr,out);
+
+                    // reached nodes which are not reused: the position of their constants, their number in the order of evaluation and the previous such node of the same type
+                    struct Node
+                    {
+                        std::size_t first = 0;
+                        std::size_t visit = 0;
+                        std::size_t previous = none;
+                    };
+                    std::array<Node,nodes> distinct{};
+                    std::array<std::size_t,nodes> last{}; // last of the nodes above for every type in types
+                    std::array<const char*,nodes> types{};
+                    std::size_t distinctCount = 0, typeCount = 0, visits = 0, constants = 0;
+
+                    auto build = [&](const auto &self, const auto &node) -> void
+                    {
+                        using U = std::remove_cvref_t<decltype(node)>;
+                        if constexpr (is_shareable_v<U> && (NodeTraits<U>::isBinary || NodeTraits<U>::isUnary))
+                        {
+                            const std::size_t k = visits++;
+                            slots[k] = none;
+                            std::size_t type = 0;
+                            while (type < typeCount && types[type] != &type_tag<U>) {++type;}
+                            if (type == typeCount)
+                            {
+                                types[typeCount++] = &type_tag<U>;
+                                last[type] = none;
+                            }
+                            for (std::size_t i = last[type]; i != none; i = distinct[i].previous)
+                            {
+                                bool equal = true;
+                                for (std::size_t c = 0; c < ConstantCount<U>::value && equal; ++c) {equal = values[distinct[i].first + c] == values[constants + c];}
+                                if (!equal) {continue;}
+
+                                std::uint32_t &slot = slots[distinct[i].visit];
+                                if (slot == none) {slot = static_cast<std::uint32_t>(size++);}
+                                slots[k] = slot;
+                                reused[k] = true;
+                                constants += ConstantCount<U>::value;
+                                return;
+                            }
+                            distinct[distinctCount] = Node{constants,k,last[type]};
+                            last[type] = distinctCount++;
+                        }
+                        if constexpr (NodeTraits<U>::isBinary)
+                        {
+                            self(self,node.Lhs());
+                            self(self,node.Rhs());
+                        }
+                        else if constexpr (NodeTraits<U>::isUnary)
+                        {
+                            self(self,node.Arg());
+                        }
+                        else if constexpr (is_key_v<U>)
+                        {
+                            ++constants;
+                        }
+                    };
+                    build(build,expr);
+                }
+            };
+
+            // values of the repeated subtrees, there are at most half as many as the shareable nodes
+            template <typename R, std::size_t N>
+            struct SharedValues
+            {
+                std::array<R,N / 2> values;
+                std::size_t visits = 0;
+            };
+
+            template <typename Plan, typename T, typename Cache, typename ... Args>
+            [[nodiscard]] constexpr auto evaluate_node(const T &expr, const Plan &plan, Cache &cache, Args &... args);
+
+            template <typename Plan, typename T, typename Cache, typename ... Args>
+            [[nodiscard]] constexpr auto evaluate_cached(const T &expr, const Plan &plan, Cache &cache, Args &... args)
+            {
+                if constexpr (is_shareable_v<T> && (NodeTraits<T>::isBinary || NodeTraits<T>::isUnary))
+                {
+                    using R = std::remove_cvref_t<decltype(cache.values[0])>;
+                    using V = decltype(evaluate_node(expr,plan,cache,args...));
+                    const std::size_t k = cache.visits++;
+                    const std::uint32_t slot = plan.slots[k];
+                    if (slot == Plan::none)
+                    {
+                        return evaluate_node(expr,plan,cache,args...);
+                    }
+                    else if (plan.reused[k])
+                    {
+                        // values of other types than the one of the whole expression are not stored, the reused nodes are not descended into either way
+                        if constexpr (std::is_same_v<V,R>) {return cache.values[slot];}
+                        else {return static_cast<V>(expr(args...));}
+                    }
+                    else
+                    {
+                        const V value = evaluate_node(expr,plan,cache,args...);
+                        if constexpr (std::is_same_v<V,R>) {cache.values[slot] = value;}
+                        return value;
+                    }
+                }
+                else
+                {
+                    return evaluate_node(expr,plan,cache,args...);
+                }
+            }
+
+            template <typename Plan, typename T, typename Cache, typename ... Args>
+            [[nodiscard]] constexpr auto evaluate_node(const T &expr, const Plan &plan, Cache &cache, Args &... args)
+            {
+                if constexpr (NodeTraits<T>::isBinary)
+                {
+                    const auto lhs = evaluate_cached(expr.Lhs(),plan,cache,args...);
+                    const auto rhs = evaluate_cached(expr.Rhs(),plan,cache,args...);
+                    return typename NodeTraits<T>::Operation{}(lhs,rhs);
+                }
+                else if constexpr (NodeTraits<T>::isUnary)
+                {
+                    return typename NodeTraits<T>::Operation{}(evaluate_cached(expr.Arg(),plan,cache,args...));
+                }
+                else
+                {
+                    return expr(args...);
+                }
+            }
+
+            // evaluates the (simplified) expression, computing every repeated subtree (see SharingPlan) only once
+            template <typename T, typename ... Args>
+            [[nodiscard]] constexpr decltype(auto) evaluate_shared(const T &expr, const SharingPlan<T> &plan, Args &&... args)
+            {
+                if constexpr (SharingPlan<T>::nodes < 2)
+                {
+                    return expr(std::forward<Args>(args)...);
+                }
+                else
+                {
+                    if (plan.size == 0) {return expr(std::forward<Args>(args)...);}
+                    SharedValues<std::remove_cvref_t<decltype(expr(args...))>,SharingPlan<T>::nodes> cache;
+                    return evaluate_cached(expr,plan,cache,args...);
+                }
+            }
+        }
+
+        // Rewrites the expression tree: folds the zero/one identities and the constant subexpressions, removes the Function and Derivative wrappers, e.g.
+        // simplify(Literal<0>{} * x + Literal<1>{} * y) is equivalent to y
+        template <typename T>
+        [[nodiscard]] constexpr auto simplify(const T &expr)
+        {
+            if constexpr (detail::IsFunction<T>::value)
+            {
+                return simplify(expr.Callable());
+            }
+            else if constexpr (detail::IsDerivative<T>::value)
+            {
+                return expr.Expand();
+            }
+            else if constexpr (detail::NodeTraits<T>::isBinary)
+            {
+                return detail::fold(typename detail::NodeTraits<T>::Operation{},simplify(expr.Lhs()),simplify(expr.Rhs()));
+            }
+            else if constexpr (detail::NodeTraits<T>::isUnary)
+            {
+                return detail::fold(typename detail::NodeTraits<T>::Operation{},simplify(expr.Arg()));
+            }
+            else
+            {
+                return expr;
+            }
+        }
+    }
+
+#endif
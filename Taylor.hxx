@@ -0,0 +1,67 @@
+#ifndef Taylor_hxx
+    #define Taylor_hxx
+
+    #include <array>
+    #include <type_traits>
+
+    #include "Expressions.hxx"
+    #include "Jet.hxx"
+
+    namespace femto
+    {
+        // argument holding the jet of the variable T, it is accepted by Variable<T> in place of T
+        template <typename T, std::size_t N>
+        struct Expansion
+        {
+            Jet<N> value;
+            [[nodiscard]] constexpr Jet<N> operator()() const {return value;}
+        };
+
+        namespace detail
+        {
+            template <typename T, std::size_t N>
+            struct VariableOf<Expansion<T,N> >
+            {
+                using type = T;
+            };
+
+            // replaces the argument of the variable T by its jet, the other arguments are passed unchanged
+            template <typename T, std::size_t N, typename Arg>
+            [[nodiscard]] constexpr decltype(auto) expand(Arg &&arg)
+            {
+                if constexpr (std::is_same_v<typename VariableOf<std::remove_cvref_t<Arg> >::type,T>)
+                {
+                    return Expansion<T,N>{Jet<N>::Seed(static_cast<double>(arg()))};
+                }
+                else
+                {
+                    return std::forward<Arg>(arg);
+                }
+            }
+        }
+
+        // Evaluates func once on jets and returns its Taylor expansion of order N in the variable T around the point given by args, e.g.
+        // Jet<4> jet = taylor<4>(f,x,X{1.},Y{2.}); jet.Derivatives()[k] is d^k f / dx^k at (1,2)
+        template <std::size_t N, typename F, typename T, typename ... Args>
+        [[nodiscard]] constexpr Jet<N> taylor(const F &func, Variable<T>, Args &&... args)
+        {
+            const auto result = func(detail::expand<T,N>(std::forward<Args>(args))...);
+            if constexpr (Taylor<decltype(result)>)
+            {
+                return result;
+            }
+            else // func does not depend on T
+            {
+                return Jet<N>(static_cast<double>(result));
+            }
+        }
+
+        // f, df/dx, ..., d^N f / dx^N in one pass over the expression tree, in O(N^2) operations per node instead of the nested d() calls
+        template <std::size_t N, typename F, typename T, typename ... Args>
+        [[nodiscard]] constexpr std::array<double,N + 1> derivatives(const F &func, Variable<T> var, Args &&... args)
+        {
+            return taylor<N>(func,var,std::forward<Args>(args)...).Derivatives();
+        }
+    }
+
+#endif
@@ -0,0 +1,191 @@
+#ifndef ThreadPool_hxx
+    #define ThreadPool_hxx
+
+    #include <algorithm>
+    #include <atomic>
+    #include <condition_variable>
+    #include <cstddef>
+    #include <exception>
+    #include <functional>
+    #include <memory>
+    #include <mutex>
+    #include <thread>
+    #include <vector>
+
+    namespace femto
+    {
+        // Fixed set of worker threads executing parallel loops. The calling thread takes part in the loop as worker 0.
+        class ThreadPool
+        {
+            private:
+                // part of the iteration space owned by one worker; the owner takes from the front, thieves from the back
+                struct alignas(64) Range
+                {
+                    std::mutex mutex;
+                    std::size_t begin = 0;
+                    std::size_t end = 0;
+                };
+
+                std::vector<std::jthread> m_threads;
+                std::mutex m_caller; // the job state below belongs to one ParallelFor call at a time
+                std::mutex m_mutex;
+                std::condition_variable m_wake;
+                std::condition_variable m_done;
+                std::function<void(std::size_t)> m_job;
+                std::size_t m_generation = 0;
+                std::size_t m_busy = 0;
+                bool m_stop = false;
+
+                void Work(std::size_t worker)
+                {
+                    std::size_t seen = 0;
+                    while (true)
+                    {
+                        std::unique_lock lock(m_mutex);
+                        m_wake.wait(lock,[&]{return m_stop || m_generation != seen;});
+                        if (m_stop) {return;}
+                        seen = m_generation;
+                        lock.unlock();
+
+                        m_job(worker);
+
+                        lock.lock();
+                        if (--m_busy == 0) {m_done.notify_one();}
+                    }
+                }
+
+                // takes the next grain from the own range or, once it is empty, steals half of the range of another worker
+                static bool Next(std::vector<std::unique_ptr<Range> > &ranges, std::size_t worker, std::size_t grain, std::size_t &begin, std::size_t &end)
+                {
+                    Range &own = *ranges[worker];
+                    {
+                        std::scoped_lock lock(own.mutex);
+                        if (own.begin < own.end)
+                        {
+                            begin = own.begin;
+                            end = std::min(own.begin + grain,own.end);
+                            own.begin = end;
+                            return true;
+                        }
+                    }
+                    for (std::size_t i = 1; i < ranges.size(); ++i)
+                    {
+                        Range &victim = *ranges[(worker + i) % ranges.size()];
+                        std::scoped_lock lock(victim.mutex);
+                        if (victim.begin >= victim.end) {continue;}
+
+                        const std::size_t left = victim.end - victim.begin;
+                        const std::size_t stolen = (left > grain) ? left / 2 : left;
+                        begin = victim.end - stolen;
+                        end = std::min(begin + grain,victim.end);
+                        victim.end = begin;
+                        if (end < begin + stolen)
+                        {
+                            std::scoped_lock ownLock(own.mutex);
+                            own.begin = end;
+                            own.end = begin + stolen;
+                        }
+                        return true;
+                    }
+                    return false;
+                }
+
+            public:
+                explicit ThreadPool(std::size_t threads = std::max<std::size_t>(std::thread::hardware_concurrency(),1))
+                {
+                    for (std::size_t i = 1; i < threads; ++i)
+                    {
+                        m_threads.emplace_back([this,i]{Work(i);});
+                    }
+                }
+                ThreadPool(const ThreadPool&) = delete;
+                ThreadPool& operator=(const ThreadPool&) = delete;
+                ~ThreadPool()
+                {
+                    {
+                        std::scoped_lock lock(m_mutex);
+                        m_stop = true;
+                    }
+                    m_wake.notify_all();
+                    m_threads.clear(); // joins the workers while the synchronisation members are still alive
+                }
+                [[nodiscard]] std::size_t Size() const {return m_threads.size() + 1;}
+
+                // Calls func(begin,end,worker) for consecutive chunks of at most grain elements, which together cover [0,count).
+                // Blocks until all chunks are processed. If func throws, the remaining chunks are skipped and the first exception is rethrown once every worker has left the loop.
+                // Any number of threads may call it on the same pool, their loops are run one after another.
+                // Must not be called on the same pool from inside func, which would wait for its own loop to finish.
+                template <typename F>
+                void ParallelFor(std::size_t count, std::size_t grain, F &&func)
+                {
+                    if (count == 0) {return;}
+                    grain = std::max<std::size_t>(grain,1);
+
+                    const std::size_t workers = std::min(Size(),(count + grain - 1) / grain);
+                    if (workers == 1) // not worth waking up the pool
+                    {
+                        for (std::size_t begin = 0; begin < count; begin += grain)
+                        {
+                            func(begin,std::min(begin + grain,count),std::size_t(0));
+                        }
+                        return;
+                    }
+
+                    std::scoped_lock caller(m_caller);
+                    std::vector<std::unique_ptr<Range> > ranges(workers);
+                    for (std::size_t i = 0; i < workers; ++i)
+                    {
+                        ranges[i] = std::make_unique<Range>();
+                        ranges[i]->begin = count * i / workers;
+                        ranges[i]->end = count * (i + 1) / workers;
+                    }
+
+                    std::atomic<bool> failed = false;
+                    std::exception_ptr error;
+                    std::mutex errorMutex;
+                    auto job = [&](std::size_t worker)
+                    {
+                        if (worker >= workers) {return;}
+                        std::size_t begin = 0, end = 0;
+                        try
+                        {
+                            while (!failed.load(std::memory_order_relaxed) && Next(ranges,worker,grain,begin,end))
+                            {
+                                func(begin,end,worker);
+                            }
+                        }
+                        catch (...)
+                        {
+                            std::scoped_lock lock(errorMutex);
+                            if (!error) {error = std::current_exception();}
+                            failed = true;
+                        }
+                    };
+
+                    {
+                        std::scoped_lock lock(m_mutex);
+                        m_job = job;
+                        m_busy = m_threads.size();
+                        ++m_generation;
+                    }
+                    m_wake.notify_all();
+                    job(0);
+
+                    {
+                        // the workers use the locals above until they are done, even if the loop has failed
+                        std::unique_lock lock(m_mutex);
+                        m_done.wait(lock,[&]{return m_busy == 0;});
+                    }
+                    if (error) {std::rethrow_exception(error);}
+                }
+        };
+
+        // pool shared by the algorithms which are not given one explicitly
+        [[nodiscard]] inline ThreadPool& default_pool()
+        {
+            static ThreadPool pool;
+            return pool;
+        }
+    }
+
+#endif
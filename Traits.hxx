@@ -0,0 +1,130 @@
+#ifndef Traits_hxx
+    #define Traits_hxx
+
+    #include <array>
+    #include <cstddef>
+    #include <tuple>
+    #include <type_traits>
+
+    namespace femto
+    {
+        namespace detail
+        {
+            // compile-time list of types
+            template <typename ... Ts>
+            struct TypeList
+            {
+                static constexpr std::size_t size = sizeof...(Ts);
+
+                template <std::size_t I>
+                using At = std::tuple_element_t<I,std::tuple<Ts...> >;
+            };
+
+            template <typename T, typename List>
+            struct Contains;
+
+            template <typename T, typename ... Ts>
+            struct Contains<T,TypeList<Ts...> > : std::bool_constant<(std::is_same_v<T,Ts> || ...)> {};
+
+            template <typename T, typename List>
+            inline constexpr bool contains_v = Contains<T,List>::value;
+
+            // position of the first occurence of T in the list, or the size of the list if T is absent
+            template <typename T, typename List>
+            struct IndexOf;
+
+            template <typename T, typename ... Ts>
+            struct IndexOf<T,TypeList<Ts...> >
+            {
+                static constexpr std::size_t value = []()
+                {
+                    constexpr std::array<bool,sizeof...(Ts) + 1> same{{std::is_same_v<T,Ts>...,true}};
+                    std::size_t i = 0;
+                    while (!same[i]) {++i;}
+                    return i;
+                }();
+            };
+
+            template <typename T, typename List>
+            inline constexpr std::size_t index_of_v = IndexOf<T,List>::value;
+
+            template <typename ... Lists>
+            struct Concat
+            {
+                using type = TypeList<>;
+            };
+
+            template <typename ... Ts>
+            struct Concat<TypeList<Ts...> >
+            {
+                using type = TypeList<Ts...>;
+            };
+
+            template <typename ... Ts, typename ... Us, typename ... Lists>
+            struct Concat<TypeList<Ts...>,TypeList<Us...>,Lists...>
+            {
+                using type = typename Concat<TypeList<Ts...,Us...>,Lists...>::type;
+            };
+
+            template <typename ... Lists>
+            using concat_t = typename Concat<Lists...>::type;
+
+            // removes the duplicates, keeping the order of the first occurences
+            template <typename List, typename Result = TypeList<> >
+            struct Unique
+            {
+                using type = Result;
+            };
+
+            template <typename T, typename ... Ts, typename ... Rs>
+            struct Unique<TypeList<T,Ts...>,TypeList<Rs...> >
+            {
+                using type = typename Unique<TypeList<Ts...>,std::conditional_t<contains_v<T,TypeList<Rs...> >,TypeList<Rs...>,TypeList<Rs...,T> > >::type;
+            };
+
+            template <typename List>
+            using unique_t = typename Unique<List>::type;
+        }
+
+        template <typename T> class Function;
+        template <typename T> class Variable;
+        template <typename T, typename U, typename Op> class BinaryOp;
+        template <typename T, typename Op> class UnaryOp;
+        template <typename T, typename U> class Derivative;
+
+        namespace detail
+        {
+            // types of the variables the expression depends on, in the order of their first appearance
+            template <typename T>
+            struct Variables
+            {
+                using type = TypeList<>;
+            };
+
+            template <typename T>
+            struct Variables<Variable<T> >
+            {
+                using type = TypeList<T>;
+            };
+
+            template <typename T>
+            struct Variables<Function<T> > : Variables<T> {};
+
+            template <typename T, typename U>
+            struct Variables<Derivative<T,U> > : Variables<T> {};
+
+            template <typename T, typename U, typename Op>
+            struct Variables<BinaryOp<T,U,Op> >
+            {
+                using type = unique_t<concat_t<typename Variables<T>::type,typename Variables<U>::type> >;
+            };
+
+            template <typename T, typename Op>
+            struct Variables<UnaryOp<T,Op> > : Variables<T> {};
+
+            template <typename T>
+            using variables_t = typename Variables<std::remove_cvref_t<T> >::type;
+        }
+    }
+
+#endif
@@ -0,0 +1,140 @@
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+#include "Batch.hxx"
+#include "Benchmark.hxx"
+#include "Cost.hxx"
+#include "bench_functions.hxx"
+
+// the cost model on small expressions whose trees are known
+namespace cost_checks
+{
+    using namespace femto;
+    using namespace BinaryOperations;
+    using namespace UnaryOperations;
+
+    inline constexpr auto sum = Constant(2.) * r + exp(r); // +(*(2,r),exp(r))
+    static_assert(node_count<Variable<R> > == 1 && depth<Variable<R> > == 1 && op_count<Sum,Variable<R> > == 0);
+    static_assert(node_count<decltype(sum)> == 6 && depth<decltype(sum)> == 3);
+    static_assert(op_count<Sum,decltype(sum)> == 1 && op_count<Multiplication,decltype(sum)> == 1 && exp_count<decltype(sum)> == 1 && ln_count<decltype(sum)> == 0);
+
+    inline constexpr Function quotient = sqrt(r * r + Constant(1.)) / ln(r); // /(sqrt(+(*(r,r),1)),ln(r)), the Function wrapper is transparent
+    static_assert(node_count<decltype(quotient)> == 9 && depth<decltype(quotient)> == 5);
+    static_assert(cost(quotient).sums == 1 && cost(quotient).products == 1 && cost(quotient).divisions == 1 && cost(quotient).squareRoots == 1
+        && cost(quotient).logarithms == 1 && cost(quotient).powers == 0 && cost(quotient).exponentials == 0);
+
+    inline constexpr auto power = pow(r,Constant(3)) - r;
+    static_assert(cost(power).nodes == 5 && cost(power).depth == 3 && cost(power).sums == 1 && pow_count<decltype(power)> == 1);
+
+    // a Derivative is measured by its simplified expansion: exp(r) * 1 is folded to exp(r)
+    inline constexpr auto dexp = d(exp(r),diff_wrt(r));
+    static_assert(node_count<decltype(dexp)> == 2 && depth<decltype(dexp)> == 2 && exp_count<decltype(dexp)> == 1 && op_count<Multiplication,decltype(dexp)> == 0);
+}
+
+// evaluation throughput and static cost of the derivative of the given order
+template <std::size_t Order, typename F>
+void profile(std::string_view name, const F &func, const std::vector<double> &rs)
+{
+    using namespace femto;
+    const auto df = derivative<Order>(func);
+    using D = std::remove_cvref_t<decltype(df)>;
+
+    std::vector<double> out(rs.size());
+    const double scalarNs = bench::measure_ns([&]
+    {
+        for (std::size_t i = 0; i < rs.size(); ++i) {out[i] = df(R{rs[i]});}
+        bench::do_not_optimise(out);
+    });
+    const double batchedNs = bench::measure_ns([&]
+    {
+        evaluate<R>(df,out,rs);
+        bench::do_not_optimise(out);
+    });
+
+    std::cout << std::setw(12) << name << std::setw(7) << Order << std::setw(8) << node_count<D> << std::setw(7) << depth<D>
+        << std::setw(6) << exp_count<D> << std::setw(6) << ln_count<D> << std::setw(6) << pow_count<D> << std::setw(10) << std::string_view(typeid(detail::evaluated_t<D>).name()).size()
+        << std::setw(14) << scalarNs / rs.size() << std::setw(14) << batchedNs / rs.size() << std::setw(12) << rs.size() / batchedNs * 1e3 << "\n";
+}
+
+template <typename F>
+void profile_orders(std::string_view name, const F &func, const std::vector<double> &rs)
+{
+    [&]<std::size_t ... Orders>(std::index_sequence<Orders...>)
+    {
+        (profile<Orders>(name,func,rs), ...);
+    }(std::make_index_sequence<5>{});
+}
+
+// compiles bench_compile.cxx with the derivatives of the given order, returns true on success; the diagnostics are printed only if quiet is false
+bool compile(std::size_t order, std::size_t templateDepth = 0, bool quiet = true)
+{
+    std::string command = std::string(FEMTO_CXX_COMPILER) + " -std=c++20 -fsyntax-only -I\"" FEMTO_SOURCE_DIR "\" -DFEMTO_PROBE_ORDER=" + std::to_string(order);
+    if (templateDepth > 0) {command += " -ftemplate-depth=" + std::to_string(templateDepth);}
+    command += " \"" FEMTO_SOURCE_DIR "/bench_compile.cxx\"";
+    if (quiet) {command += " > /dev/null 2>&1";}
+    return std::system(command.c_str()) == 0; // -1 if the shell could not be started, the exit status of the compiler otherwise
+}
+
+// usage: bench [--no-compile]
+int main(int argc, char **argv)
+{
+    const bool profileCompilation = !(argc > 1 && std::string_view(argv[1]) == "--no-compile");
+
+    std::vector<double> rs(1 << 16);
+    for (std::size_t i = 0; i < rs.size(); ++i) {rs[i] = 0.1 + 10. * static_cast<double>(i) / static_cast<double>(rs.size());}
+
+    std::cout << "evaluation of the functions and their derivatives with respect to r, " << rs.size() << " points\n"
+        << std::setw(12) << "function" << std::setw(7) << "order" << std::setw(8) << "nodes" << std::setw(7) << "depth"
+        << std::setw(6) << "exp" << std::setw(6) << "ln" << std::setw(6) << "pow" << std::setw(10) << "type len."
+        << std::setw(14) << "scalar [ns]" << std::setw(14) << "batched [ns]" << std::setw(12) << "Mevals/s" << "\n";
+    profile_orders("Woods-Saxon",woodsSaxon,rs);
+    profile_orders("Yukawa",yukawa,rs);
+    profile_orders("Gaussian",gaussian,rs);
+    profile_orders("power-log",powerLog,rs);
+
+    if (!profileCompilation) {return 0;}
+    if (std::system(nullptr) == 0)
+    {
+        std::cout << "\nno shell to run the compiler, the compilation is not profiled\n";
+        return 1;
+    }
+
+    // compile time of bench_compile.cxx (all four functions) and the smallest -ftemplate-depth which still compiles it; order 0 is the cost of the headers alone
+    std::cout << "\ncompilation of the derivatives of all the functions (" << FEMTO_CXX_COMPILER << " -fsyntax-only)\n"
+        << std::setw(7) << "order" << std::setw(12) << "time [s]" << std::setw(18) << "template depth" << "\n";
+    for (std::size_t order = 0; order <= 4; ++order)
+    {
+        // only the runs which compiled are timed, a failure would measure how quickly the compiler gave up
+        double best = 1e300;
+        for (std::size_t i = 0; i < 3; ++i)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            if (!compile(order))
+            {
+                std::cout << std::setw(7) << order << "  compilation failed:\n" << std::flush;
+                compile(order,0,false);
+                return 1;
+            }
+            best = std::min(best,std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+        }
+
+        std::size_t lower = 1, upper = 1024;
+        if (!compile(order,upper))
+        {
+            std::cout << std::setw(7) << order << std::setw(12) << best << std::setw(18) << "> 1024" << "\n";
+            continue;
+        }
+        while (lower < upper)
+        {
+            const std::size_t mid = (lower + upper) / 2;
+            if (compile(order,mid)) {upper = mid;} else {lower = mid + 1;}
+        }
+        std::cout << std::setw(7) << order << std::setw(12) << best << std::setw(18) << upper << "\n";
+    }
+}
@@ -0,0 +1,128 @@
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+#include "Batch.hxx"
+#include "Benchmark.hxx"
+
+struct X
+{
+    double x;
+    constexpr double operator()() {return x;}
+};
+
+struct Y
+{
+    double y;
+    constexpr double operator()() {return y;}
+};
+
+// one point at a time, the compiler is not allowed to vectorise this loop
+template <typename F>
+[[gnu::noinline, gnu::optimize("no-tree-vectorize")]] void scalar_loop(const F &func, const std::vector<double> &xs, const std::vector<double> &ys, std::vector<double> &out)
+{
+    for (std::size_t i = 0; i < xs.size(); ++i)
+    {
+        out[i] = func(X{xs[i]},Y{ys[i]});
+    }
+}
+
+// returns false if the batched results differ from the scalar ones by more than a few ulp
+template <typename F>
+bool compare(std::string_view name, const F &func, const std::vector<double> &xs, const std::vector<double> &ys)
+{
+    std::vector<double> scalar(xs.size()), autoVectorised(xs.size()), batched(xs.size());
+
+    const double scalarNs = femto::bench::measure_ns([&]
+    {
+        scalar_loop(func,xs,ys,scalar);
+        femto::bench::do_not_optimise(scalar);
+    });
+    // the same loop, which gcc -O3 may vectorise on its own when func is simple enough
+    const double autoNs = femto::bench::measure_ns([&]
+    {
+        for (std::size_t i = 0; i < xs.size(); ++i)
+        {
+            autoVectorised[i] = func(X{xs[i]},Y{ys[i]});
+        }
+        femto::bench::do_not_optimise(autoVectorised);
+    });
+    const double batchedNs = femto::bench::measure_ns([&]
+    {
+        femto::evaluate<X,Y>(func,batched,xs,ys);
+        femto::bench::do_not_optimise(batched);
+    });
+
+    double maxDiff = 0;
+    bool passed = true;
+    for (std::size_t i = 0; i < xs.size(); ++i)
+    {
+        const double diff = std::abs(scalar[i] - batched[i]) / std::max(1.,std::abs(scalar[i]));
+        maxDiff = std::max(maxDiff,diff);
+        passed &= diff <= 1e-15;
+    }
+
+    std::cout << std::setw(12) << name 
+        << std::setw(16) << scalarNs / xs.size() 
+        << std::setw(16) << autoNs / xs.size() 
+        << std::setw(16) << batchedNs / xs.size() 
+        << std::setw(10) << scalarNs / batchedNs 
+        << std::setw(14) << maxDiff << std::setw(8) << (passed ? "ok" : "FAILED") << "\n";
+    return passed;
+}
+
+int main()
+{
+    constexpr std::size_t points = 1 << 20;
+
+    std::mt19937_64 gen(42);
+    std::uniform_real_distribution<double> dist(0.5,3.);
+    std::vector<double> xs(points), ys(points);
+    for (std::size_t i = 0; i < points; ++i)
+    {
+        xs[i] = dist(gen);
+        ys[i] = dist(gen);
+    }
+
+    femto::Variable<X> x;
+    femto::Variable<Y> y;
+    femto::Function f = x + y;
+    femto::Function g = x * y;
+    femto::Function h = f * g;
+    femto::Function d2h = femto::d(femto::d(h,femto::diff_wrt(x)),femto::diff_wrt(x));
+    femto::Function r = femto::sqrt(x * x + y * y);
+    femto::Function q = x / y - femto::Constant(2) * y / x;
+    femto::Function v = femto::exp(-x * y) * femto::ln(x + y);
+
+    std::cout << "SIMD width: " << femto::batch::width << " doubles, points: " << points << "\n";
+    std::cout << std::setw(12) << "function" << std::setw(16) << "scalar ns/pt" << std::setw(16) << "auto-vec ns/pt" << std::setw(16) << "batch ns/pt" 
+        << std::setw(10) << "speedup" << std::setw(14) << "max rel diff" << "\n";
+    bool passed = true;
+    passed &= compare("h",h,xs,ys);
+    passed &= compare("d2h/dx2",d2h,xs,ys);
+    passed &= compare("q",q,xs,ys);
+    passed &= compare("sqrt",r,xs,ys);
+    passed &= compare("exp*ln",v,xs,ys);
+
+    // sizes which do not fill the last pack, and mismatching spans
+    for (const std::size_t size : {std::size_t(1),femto::batch::width - 1,femto::batch::width + 3})
+    {
+        std::vector<double> out(size);
+        femto::evaluate<X,Y>(v,out,std::span(xs).first(size),std::span(ys).first(size));
+        for (std::size_t i = 0; i < size; ++i) {passed &= std::abs(out[i] - v(X{xs[i]},Y{ys[i]})) <= 1e-15 * std::abs(out[i]);}
+    }
+    try
+    {
+        std::vector<double> out(8);
+        femto::evaluate<X,Y>(v,out,std::span(xs).first(8),std::span(ys).first(7));
+        passed = false;
+    }
+    catch (const std::invalid_argument &) {}
+
+    std::cout << (passed ? "PASSED" : "FAILED") << "\n";
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,20 @@
+// Compiled by bench with -fsyntax-only to measure the compile time of the derivatives of order FEMTO_PROBE_ORDER of the functions from bench_functions.hxx.
+// Order 0 only parses the headers, and is the baseline.
+#include "bench_functions.hxx"
+
+#ifndef FEMTO_PROBE_ORDER
+    #define FEMTO_PROBE_ORDER 0
+#endif
+
+int main()
+{
+    #if FEMTO_PROBE_ORDER > 0
+        constexpr auto dWoodsSaxon = derivative<FEMTO_PROBE_ORDER>(woodsSaxon);
+        constexpr auto dYukawa = derivative<FEMTO_PROBE_ORDER>(yukawa);
+        constexpr auto dGaussian = derivative<FEMTO_PROBE_ORDER>(gaussian);
+        constexpr auto dPowerLog = derivative<FEMTO_PROBE_ORDER>(powerLog);
+        return static_cast<int>(dWoodsSaxon(R{1.}) + dYukawa(R{1.}) + dGaussian(R{1.}) + dPowerLog(R{1.}));
+    #else
+        return 0;
+    #endif
+}
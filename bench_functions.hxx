@@ -0,0 +1,34 @@
+#ifndef bench_functions_hxx
+    #define bench_functions_hxx
+
+    #include "Expressions.hxx"
+
+    // representative functions profiled by bench and bench_compile, all of them depend on the radius only
+    struct R {double r; constexpr double operator()() {return r;}};
+
+    inline constexpr femto::Variable<R> r;
+
+    // Woods-Saxon potential
+    inline constexpr femto::Function woodsSaxon = femto::Constant(-50.) / (femto::Constant(1.) + femto::exp((r - femto::Constant(4.)) / femto::Constant(0.65)));
+    // Yukawa potential
+    inline constexpr femto::Function yukawa = femto::Constant(-10.) * femto::exp(femto::Constant(-0.7) * r) / r;
+    // Gaussian wavefunction
+    inline constexpr femto::Function gaussian = femto::exp(-(r * r) / femto::Constant(2.));
+    // power law with a logarithmic correction
+    inline constexpr femto::Function powerLog = femto::pow(r,femto::Constant(2.5)) * femto::ln(femto::Constant(1.) + r) + femto::sqrt(r);
+
+    // derivative of the given order with respect to r, built by nesting d()
+    template <std::size_t Order, typename F>
+    [[nodiscard]] constexpr auto derivative(const F &func)
+    {
+        if constexpr (Order == 0)
+        {
+            return func;
+        }
+        else
+        {
+            return femto::d(derivative<Order - 1>(func),femto::diff_wrt(r));
+        }
+    }
+
+#endif
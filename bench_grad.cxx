@@ -0,0 +1,77 @@
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <string_view>
+#include <utility>
+#include "Gradient.hxx"
+
+struct X
+{
+    double x;
+    constexpr double operator()() const {return x;}
+};
+
+struct Y
+{
+    double y;
+    constexpr double operator()() const {return y;}
+};
+
+// difference of value from the reference, relative for references larger than 1, NaN if either is not finite
+double rel_error(double value, double reference)
+{
+    if (!std::isfinite(value) || !std::isfinite(reference)) {return std::numeric_limits<double>::quiet_NaN();}
+    return std::abs(value - reference) / std::max(1.,std::abs(reference));
+}
+
+// compares value_and_grad and grad of func with d(func,x) and d(func,y) at the point (valx,valy)
+template <typename F>
+bool check(std::string_view name, const F &func, double valx, double valy)
+{
+    using namespace femto;
+    constexpr double tolerance = 1e-12;
+    Variable<X> x;
+    Variable<Y> y;
+    const auto [value,gradient] = value_and_grad(func)(X{valx},Y{valy});
+    const auto partials = grad(func)(X{valx},Y{valy});
+    const double dfdx = d(func,diff_wrt(x))(X{valx},Y{valy});
+    const double dfdy = d(func,diff_wrt(y))(X{valx},Y{valy});
+    double err = 0;
+    bool passed = true;
+    for (const double e : {rel_error(value,func(X{valx},Y{valy})),rel_error(gradient[x],dfdx),rel_error(gradient[y],dfdy),rel_error(partials[x],dfdx),rel_error(partials[y],dfdy)})
+    {
+        err = std::isnan(e) ? e : std::max(err,e);
+        passed &= e <= tolerance;
+    }
+    std::cout << std::setw(28) << name << std::setw(8) << valx << std::setw(8) << valy << std::setw(14) << gradient[x] << std::setw(14) << gradient[y]
+        << std::setw(12) << err << std::setw(8) << (passed ? "ok" : "FAILED") << "\n";
+    return passed;
+}
+
+int main()
+{
+    using namespace femto;
+    Variable<X> x;
+    Variable<Y> y;
+
+    std::cout << std::setprecision(6) << std::setw(28) << "function" << std::setw(8) << "x" << std::setw(8) << "y" << std::setw(14) << "df/dx" << std::setw(14) << "df/dy"
+        << std::setw(12) << "rel. error" << "\n";
+
+    bool passed = true;
+    for (const auto &[valx,valy] : {std::pair(0.,2.),std::pair(0.5,-1.5),std::pair(1.,2.),std::pair(-2.,0.25)})
+    {
+        passed &= check("x^2 * y + exp(x * y)",pow(x,Constant(2.)) * y + exp(x * y),valx,valy);
+        passed &= check("x^3 / (1 + y^2)",pow(x,Constant(3)) / (Constant(1.) + y * y),valx,valy);
+        passed &= check("sqrt(x^2 + y^2) - x * y",sqrt(x * x + y * y) - x * y,valx,valy);
+    }
+    // the exponent depends on a variable, the base has to be positive
+    for (const auto &[valx,valy] : {std::pair(0.5,2.),std::pair(3.,-0.5)})
+    {
+        passed &= check("x^y + ln(x) * y",pow(x,y) + ln(x) * y,valx,valy);
+    }
+
+    std::cout << (passed ? "PASSED" : "FAILED") << "\n";
+    return passed ? 0 : 1;
+}
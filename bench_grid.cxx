@@ -0,0 +1,134 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include "Grid.hxx"
+#include "Benchmark.hxx"
+
+struct X
+{
+    double x;
+    constexpr double operator()() {return x;}
+};
+
+struct Y
+{
+    double y;
+    constexpr double operator()() {return y;}
+};
+
+struct Z
+{
+    double z;
+    constexpr double operator()() {return z;}
+};
+
+// the values of func at the points of the grid, one point at a time in the row-major order
+template <typename F, typename G>
+std::vector<double> scalar_loop(const F &func, const G &grid)
+{
+    std::vector<double> values;
+    values.reserve(grid.Size());
+    for (const double valx : grid.template GetAxis<X>().Points())
+    {
+        for (const double valy : grid.template GetAxis<Y>().Points())
+        {
+            for (const double valz : grid.template GetAxis<Z>().Points()) {values.push_back(func(X{valx},Y{valy},Z{valz}));}
+        }
+    }
+    return values;
+}
+
+// largest difference relative to the reference values larger than 1, NaN if the sizes differ or a value is NaN
+double max_error(const std::vector<double> &values, const std::vector<double> &reference)
+{
+    if (values.size() != reference.size()) {return NAN;}
+    double err = 0;
+    for (std::size_t i = 0; i < values.size(); ++i)
+    {
+        const double e = std::abs(values[i] - reference[i]) / std::max(1.,std::abs(reference[i]));
+        err = std::isnan(e) ? e : std::max(err,e);
+    }
+    return err;
+}
+
+// usage: bench_grid [points per axis] [max threads]
+int main(int argc, char **argv)
+{
+    const std::size_t perAxis = (argc > 1) ? std::strtoul(argv[1],nullptr,10) : 200;
+    const std::size_t maxThreads = (argc > 2) ? std::strtoul(argv[2],nullptr,10) : std::max(std::thread::hardware_concurrency(),1u);
+
+    femto::Variable<X> x;
+    femto::Variable<Y> y;
+    femto::Variable<Z> z;
+    femto::Function r2 = x * x + y * y + z * z;
+    femto::Function potential = femto::Constant(-50.) * femto::exp(-r2 / femto::Constant(4.)) + femto::Constant(1.44) / femto::sqrt(r2 + femto::Constant(0.01));
+    femto::Function force = femto::d(potential,femto::diff_wrt(x));
+
+    femto::Grid grid(femto::Axis(x,-10.,10.,perAxis),femto::Axis(y,-10.,10.,perAxis),femto::Axis(z,-10.,10.,perAxis));
+    std::vector<double> values(grid.Size());
+    const std::vector<double> potentialRef = scalar_loop(potential,grid);
+    const std::vector<double> forceRef = scalar_loop(force,grid);
+    constexpr double tolerance = 1e-14;
+    std::cout << "grid: " << perAxis << "^3 = " << grid.Size() << " points\n";
+    std::cout << std::setw(10) << "threads" << std::setw(16) << "V Mpts/s" << std::setw(16) << "dV/dx Mpts/s" << std::setw(16) << "stream Mpts/s" << std::setw(12) << "speedup"
+        << std::setw(14) << "rel. error" << "\n";
+
+    bool passed = true;
+    double reference = 0;
+    for (std::size_t threads = 1; threads <= maxThreads; threads *= 2)
+    {
+        femto::ThreadPool pool(threads);
+        const double potentialNs = femto::bench::measure_ns([&]{grid.Evaluate(potential,values,pool);},3);
+        const double forceNs = femto::bench::measure_ns([&]{grid.Evaluate(force,values,pool);},3);
+        const double streamNs = femto::bench::measure_ns([&]
+        {
+            double sum = 0;
+            grid.Stream(potential,1 << 20,[&](std::size_t, std::span<const double> chunk){for (const auto &val : chunk) {sum += val;}},pool);
+            femto::bench::do_not_optimise(sum);
+        },3);
+        if (threads == 1) {reference = potentialNs;}
+
+        // every result has to match the scalar loop, including the chunks of Stream which have to arrive in order
+        double err = 0;
+        for (const double e : {max_error(grid.Evaluate(potential,pool),potentialRef),max_error(grid.Evaluate(force,pool),forceRef)}) {err = std::isnan(e) ? e : std::max(err,e);}
+        std::vector<double> streamed;
+        grid.Stream(potential,1000,[&](std::size_t offset, std::span<const double> chunk)
+        {
+            if (offset != streamed.size()) {streamed.clear();}
+            streamed.insert(streamed.end(),chunk.begin(),chunk.end());
+        },pool);
+        const double streamErr = max_error(streamed,potentialRef);
+        err = std::isnan(streamErr) ? streamErr : std::max(err,streamErr);
+        passed &= err <= tolerance;
+
+        std::cout << std::setw(10) << threads 
+            << std::setw(16) << grid.Size() / potentialNs * 1e3 
+            << std::setw(16) << grid.Size() / forceNs * 1e3 
+            << std::setw(16) << grid.Size() / streamNs * 1e3
+            << std::setw(12) << reference / potentialNs
+            << std::setw(14) << err << "\n";
+    }
+
+    // an exception of the loop body, thrown on the caller (chunk 0) or on a worker, is passed to the caller after all workers have left the loop, and the pool stays usable
+    femto::ThreadPool pool(std::max<std::size_t>(maxThreads,2));
+    bool thrown = false;
+    try
+    {
+        pool.ParallelFor(1000,10,[](std::size_t begin, std::size_t, std::size_t){if (begin == 0 || begin == 500) {throw std::runtime_error("chunk " + std::to_string(begin));}});
+    }
+    catch (const std::runtime_error &) {thrown = true;}
+    std::size_t covered = 0;
+    std::mutex mutex;
+    pool.ParallelFor(1000,10,[&](std::size_t begin, std::size_t end, std::size_t){std::scoped_lock lock(mutex); covered += end - begin;});
+    passed &= thrown && covered == 1000;
+    std::cout << "exception passed to the caller: " << (thrown ? "yes" : "no") << ", pool usable afterwards: " << (covered == 1000 ? "yes" : "no") << "\n";
+
+    std::cout << (passed ? "PASSED" : "FAILED") << "\n";
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,101 @@
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <numbers>
+#include <string_view>
+#include <thread>
+#include "Integration.hxx"
+
+struct X1 {double v; constexpr double operator()() {return v;}};
+struct X2 {double v; constexpr double operator()() {return v;}};
+struct X3 {double v; constexpr double operator()() {return v;}};
+struct X4 {double v; constexpr double operator()() {return v;}};
+struct X5 {double v; constexpr double operator()() {return v;}};
+struct X6 {double v; constexpr double operator()() {return v;}};
+
+// integral of x^k over [a,b]
+double moment(double a, double b, int k)
+{
+    return (std::pow(b,k + 1) - std::pow(a,k + 1)) / (k + 1);
+}
+
+// The estimated error has to bound the true one and must not exceed the tolerance, unless the evaluations ran out.
+// The cubature estimate bounds the error of the embedded degree 5 rule, so the ratio of the two errors shows how conservative it is.
+template <typename F>
+bool report(std::string_view name, std::size_t threads, double exact, double tolerance, F &&integrate)
+{
+    const auto start = std::chrono::steady_clock::now();
+    const femto::IntegrationResult result = integrate();
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << std::setw(26) << name << std::setw(9) << threads
+        << std::setw(16) << std::setprecision(10) << result.value 
+        << std::setw(12) << std::setprecision(3) << result.error 
+        << std::setw(12) << std::abs(result.value - exact)
+        << std::setw(13) << result.evaluations 
+        << std::setw(12) << result.evaluations / seconds / 1e6 
+        << std::setw(10) << seconds;
+
+    const double trueError = std::abs(result.value - exact);
+    const bool passed = trueError <= result.error && result.error <= tolerance * std::abs(exact);
+    std::cout << std::setw(12) << result.error / trueError << std::setw(8) << (passed ? "ok" : "FAILED") << "\n";
+    return passed;
+}
+
+// usage: bench_integrate [max threads]
+int main(int argc, char **argv)
+{
+    using namespace femto;
+    const std::size_t maxThreads = (argc > 1) ? std::strtoul(argv[1],nullptr,10) : std::max(std::thread::hardware_concurrency(),1u);
+
+    Variable<X1> x1;
+    Variable<X2> x2;
+    Variable<X3> x3;
+    Variable<X4> x4;
+    Variable<X5> x5;
+    Variable<X6> x6;
+
+    // normalisation of a Gaussian wavepacket and of the hydrogen ground state density |psi_1s|^2 = exp(-2r) / pi (in units of the Bohr radius)
+    Function gauss = exp(-(x1 * x1 + x2 * x2 + x3 * x3));
+    Function hydrogen = exp(Constant(-2.) * sqrt(x1 * x1 + x2 * x2 + x3 * x3)) / Constant(std::numbers::pi);
+    Function gauss6 = exp(-(x1 * x1 + x2 * x2 + x3 * x3 + x4 * x4 + x5 * x5 + x6 * x6));
+
+    Cubature cubature(Bounds(x1,-6.,6.),Bounds(x2,-6.,6.),Bounds(x3,-6.,6.));
+    Cubature cubatureReversed(Bounds(x1,6.,-6.),Bounds(x2,-6.,6.),Bounds(x3,-6.,6.));
+    Cubature cubatureHydrogen(Bounds(x1,-20.,20.),Bounds(x2,-20.,20.),Bounds(x3,-20.,20.));
+    QuasiMonteCarlo qmc(Bounds(x1,-4.,4.),Bounds(x2,-4.,4.),Bounds(x3,-4.,4.),Bounds(x4,-4.,4.),Bounds(x5,-4.,4.),Bounds(x6,-4.,4.));
+
+    std::cout << std::setw(26) << "integral" << std::setw(9) << "threads" << std::setw(16) << "value" << std::setw(12) << "est. error" 
+        << std::setw(12) << "true error" << std::setw(13) << "evaluations" << std::setw(12) << "Mevals/s" << std::setw(10) << "time [s]" << std::setw(12) << "est./true" << "\n";
+    bool passed = true;
+    for (std::size_t threads = 1; threads <= maxThreads; threads *= 2)
+    {
+        ThreadPool pool(threads);
+        passed &= report("Gaussian 3D (cubature)",threads,std::pow(std::numbers::pi,1.5),1e-10,[&]{return cubature.Integrate(gauss,{.relativeTolerance = 1e-10},pool);});
+        passed &= report("reversed x1 (cubature)",threads,-std::pow(std::numbers::pi,1.5),1e-10,[&]{return cubatureReversed.Integrate(gauss,{.relativeTolerance = 1e-10},pool);});
+        passed &= report("hydrogen 1s (cubature)",threads,1.,1e-7,[&]{return cubatureHydrogen.Integrate(hydrogen,{.relativeTolerance = 1e-7},pool);});
+        // the spread of the replicates is a statistical estimate, it may fall below the true error
+        passed &= report("Gaussian 6D (Sobol QMC)",threads,std::pow(std::numbers::pi,3) * std::pow(std::erf(4.),6),1e-3,[&]{return qmc.Integrate(gauss6,{.points = 1 << 22},pool);});
+    }
+
+    // one region on an asymmetric box: the degree 7 rule is exact for polynomials up to degree 7, and agrees with the degree 5 rule up to degree 5
+    const double a1 = 0., b1 = 1., a2 = -1., b2 = 2., a3 = 0.5, b3 = 1.5;
+    Cubature box(Bounds(x1,a1,b1),Bounds(x2,a2,b2),Bounds(x3,a3,b3));
+    const auto quintic = x1 * x1 * x1 * x1 * x2 + x2 * x2 * x3 * x3 * x3 + x1 + Constant(2.);
+    const auto septic = x1 * x1 * x1 * x1 * x1 * x1 * x3 + x1 * x1 * x2 * x2 * x2 * x2 * x3 + quintic;
+    const double quinticExact = moment(a1,b1,4) * moment(a2,b2,1) * moment(a3,b3,0) + moment(a1,b1,0) * moment(a2,b2,2) * moment(a3,b3,3)
+        + (moment(a1,b1,1) + 2 * moment(a1,b1,0)) * moment(a2,b2,0) * moment(a3,b3,0);
+    const double septicExact = moment(a1,b1,6) * moment(a2,b2,0) * moment(a3,b3,1) + moment(a1,b1,2) * moment(a2,b2,4) * moment(a3,b3,1) + quinticExact;
+    const IntegrationResult quinticResult = box.Integrate(quintic,{.maxEvaluations = 1});
+    const IntegrationResult septicResult = box.Integrate(septic,{.maxEvaluations = 1});
+    const bool exact = std::abs(quinticResult.value - quinticExact) <= 1e-14 * quinticExact && quinticResult.error <= 1e-14 * quinticExact
+        && std::abs(septicResult.value - septicExact) <= 1e-14 * septicExact && septicResult.error > 1e-3 * septicExact;
+    std::cout << "polynomials of degree 5 and 7 on one region: errors " << std::abs(quinticResult.value - quinticExact) << ", " << std::abs(septicResult.value - septicExact)
+        << ", estimated " << quinticResult.error << ", " << septicResult.error << "  " << (exact ? "ok" : "FAILED") << "\n";
+    passed &= exact;
+
+    std::cout << (passed ? "PASSED" : "FAILED") << "\n";
+    return passed ? 0 : 1;
+}
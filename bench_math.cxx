@@ -0,0 +1,165 @@
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string_view>
+#include <vector>
+#include "Batch.hxx"
+#include "Benchmark.hxx"
+
+// distance between a and the reference in units in the last place of the reference
+double ulp_error(double value, double reference)
+{
+    if (std::isnan(value) || std::isnan(reference)) {return (std::isnan(value) && std::isnan(reference)) ? 0 : std::numeric_limits<double>::infinity();}
+    if (std::isinf(reference)) {return value == reference ? 0 : std::numeric_limits<double>::infinity();}
+    const double ulp = std::nextafter(std::abs(reference),std::numeric_limits<double>::infinity()) - std::abs(reference);
+    return std::abs(value - reference) / ulp;
+}
+
+struct Report
+{
+    double maxUlp = 0;
+    double meanUlp = 0;
+};
+
+template <typename F, typename R>
+Report accuracy(const std::vector<double> &inputs, F &&func, R &&reference)
+{
+    Report report;
+    for (const auto &val : inputs)
+    {
+        const double err = ulp_error(func(val),reference(val));
+        report.maxUlp = std::max(report.maxUlp,err);
+        report.meanUlp += err / inputs.size();
+    }
+    return report;
+}
+
+template <typename F>
+double ns_per_call(const std::vector<double> &inputs, F &&func)
+{
+    std::vector<double> out(inputs.size());
+    return femto::bench::measure_ns([&]
+    {
+        for (std::size_t i = 0; i < inputs.size(); ++i)
+        {
+            out[i] = func(inputs[i]);
+        }
+        femto::bench::do_not_optimise(out);
+    }) / inputs.size();
+}
+
+template <typename F>
+double ns_per_call_packed(const std::vector<double> &inputs, F &&func)
+{
+    std::vector<double> out(inputs.size());
+    const std::size_t bulk = inputs.size() - inputs.size() % femto::batch::width;
+    return femto::bench::measure_ns([&]
+    {
+        for (std::size_t i = 0; i < bulk; i += femto::batch::width)
+        {
+            const femto::batch::Pack result = func(femto::batch::detail::load(inputs,i));
+            std::memcpy(out.data() + i,&result,sizeof(result));
+        }
+        femto::bench::do_not_optimise(out);
+    }) / bulk;
+}
+
+std::vector<double> uniform(double min, double max, std::size_t count)
+{
+    std::mt19937_64 gen(7);
+    std::uniform_real_distribution<double> dist(min,max);
+    std::vector<double> values(count);
+    for (auto &val : values) {val = dist(gen);}
+    return values;
+}
+
+std::vector<double> log_uniform(double minExp, double maxExp, std::size_t count)
+{
+    std::vector<double> values = uniform(minExp,maxExp,count);
+    for (auto &val : values) {val = std::exp2(val);}
+    return values;
+}
+
+bool row(std::string_view name, const std::vector<double> &inputs, double maxAllowedUlp, auto &&femtoFunc, auto &&seriesFunc, auto &&stdFunc, auto &&packedFunc)
+{
+    const Report report = accuracy(inputs,femtoFunc,stdFunc);
+    // the constexpr series is very slow at runtime, so it is timed on a subset of the inputs; it also cannot handle the numbers whose inverse overflows
+    std::vector<double> subset;
+    for (std::size_t i = 0; i < inputs.size(); i += 64)
+    {
+        if (std::isfinite(1. / inputs[i])) {subset.push_back(inputs[i]);}
+    }
+
+    std::cout << std::setw(22) << name 
+        << std::setw(10) << report.maxUlp 
+        << std::setw(12) << report.meanUlp
+        << std::setw(12) << ns_per_call(inputs,femtoFunc)
+        << std::setw(12) << ns_per_call_packed(inputs,packedFunc)
+        << std::setw(12) << ns_per_call(inputs,stdFunc)
+        << std::setw(14) << ns_per_call(subset,seriesFunc) << "\n";
+    return report.maxUlp <= maxAllowedUlp;
+}
+
+int main()
+{
+    using namespace femto;
+    using batch::Pack;
+    constexpr std::size_t count = 1 << 18;
+
+    auto femtoExp = [](double x){return math::exp(x);};
+    auto seriesExp = [](double x){return math::detail_exp::exp_series(x);};
+    auto stdExp = [](double x){return std::exp(x);};
+    auto packedExp = [](Pack x){return math::exp(x);};
+    auto femtoLn = [](double x){return math::ln(x);};
+    auto seriesLn = [](double x){return math::detail_ln::ln_series(x);};
+    auto stdLn = [](double x){return std::log(x);};
+    auto packedLn = [](Pack x){return math::ln(x);};
+    auto femtoSqrt = [](double x){return math::sqrt(x);};
+    auto seriesSqrt = [](double x){return math::detail_sqrt::sqrt_newton(x);};
+    auto stdSqrt = [](double x){return std::sqrt(x);};
+    auto packedSqrt = [](Pack x){return math::sqrt(x);};
+
+    std::cout << std::setprecision(3) << "SIMD width: " << batch::width << " doubles\n";
+    std::cout << std::setw(22) << "function [range]" << std::setw(10) << "max ulp" << std::setw(12) << "mean ulp" 
+        << std::setw(12) << "femto ns" << std::setw(12) << "packed ns" << std::setw(12) << "cmath ns" << std::setw(14) << "constexpr ns" << "\n";
+
+    bool passed = true;
+    passed &= row("exp [-1,1]",uniform(-1,1,count),1.,femtoExp,seriesExp,stdExp,packedExp);
+    passed &= row("exp [-745,709]",uniform(-745,709,count),1.,femtoExp,seriesExp,stdExp,packedExp);
+    passed &= row("ln [0.5,2]",uniform(0.5,2,count),1.,femtoLn,seriesLn,stdLn,packedLn);
+    passed &= row("ln [2^-1074,2^1023]",log_uniform(-1074,1023,count),1.,femtoLn,seriesLn,stdLn,packedLn);
+    passed &= row("sqrt [0,1e6]",uniform(0,1e6,count),0.5,femtoSqrt,seriesSqrt,stdSqrt,packedSqrt);
+
+    // special values have to match <cmath>
+    constexpr double inf = std::numeric_limits<double>::infinity();
+    constexpr double nan = std::numeric_limits<double>::quiet_NaN();
+    for (const double val : {0.,-0.,1.,-1.,inf,-inf,nan,1e-310,710.,-746.})
+    {
+        passed &= ulp_error(math::exp(val),std::exp(val)) <= 1.;
+        passed &= ulp_error(math::ln(val),std::log(val)) <= 1. || (val == -0. && math::ln(val) == -inf);
+    }
+    passed &= math::pow(2.,10) == 1024. && math::pow(-2.,3.) == -8. && std::isnan(math::pow(-2.,0.5)) && ulp_error(math::pow(2.,0.5),std::sqrt(2.)) <= 2.;
+    // pow has to agree with <cmath> on all combinations of special bases and exponents, including the sign of zero and infinite results
+    for (const double base : {0.,-0.,1.,-1.,0.5,-0.5,2.,-2.,inf,-inf,nan})
+    {
+        for (const double exponent : {0.,-0.,1.,-1.,2.,-2.,3.,-3.,0.5,-0.5,65.,-65.,0x1p53,1e300,-1e300,inf,-inf,nan})
+        {
+            const double value = math::pow(base,exponent), reference = std::pow(base,exponent);
+            passed &= ulp_error(value,reference) <= 2. && (std::isnan(reference) || std::signbit(value) == std::signbit(reference));
+        }
+    }
+    // integral operands give floating-point results
+    passed &= ulp_error(math::pow(2,0.5),std::sqrt(2.)) <= 2. && math::pow(2,-1) == 0.5 && math::pow(2,3) == 8.;
+    passed &= [](Pack p){for (std::size_t i = 0; i < batch::width; ++i) {if (ulp_error(p[i],std::sqrt(2.)) > 2.) {return false;}} return true;}(math::pow(2,Pack{} + 0.5));
+    {
+        struct X {double x; constexpr double operator()() const {return x;}};
+        Variable<X> x;
+        Function pw = pow(Constant(2),x);
+        passed &= ulp_error(pw(X{0.5}),std::sqrt(2.)) <= 2.;
+    }
+
+    std::cout << (passed ? "PASSED" : "FAILED") << "\n";
+    return passed ? 0 : 1;
+}
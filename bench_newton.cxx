@@ -0,0 +1,119 @@
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include "RootFinder.hxx"
+
+struct X {double v; constexpr double operator()() {return v;}};
+struct Y {double v; constexpr double operator()() {return v;}};
+struct P {double v; constexpr double operator()() {return v;}};
+
+// times solve(), which returns the number of converged problems, and then prints the largest residual(); every problem has to converge to a root within the tolerance
+template <typename F, typename R>
+bool report(std::string_view name, std::size_t threads, std::size_t problems, F &&solve, R &&residual)
+{
+    constexpr double tolerance = 1e-14;
+    const auto start = std::chrono::steady_clock::now();
+    const std::size_t converged = solve();
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    const double worst = residual();
+    const bool passed = converged == problems && worst <= tolerance;
+    std::cout << std::setw(30) << name << std::setw(9) << threads << std::setw(11) << problems << std::setw(11) << converged
+        << std::setw(13) << problems / seconds / 1e6 << std::setw(12) << seconds << std::setw(13) << worst << std::setw(8) << (passed ? "ok" : "FAILED") << "\n";
+    return passed;
+}
+
+// usage: bench_newton [problems] [max threads]
+int main(int argc, char **argv)
+{
+    using namespace femto;
+    const std::size_t problems = (argc > 1) ? std::strtoul(argv[1],nullptr,10) : 1'000'000;
+    const std::size_t maxThreads = (argc > 2) ? std::strtoul(argv[2],nullptr,10) : std::max(std::thread::hardware_concurrency(),1u);
+
+    Variable<X> x;
+    Variable<Y> y;
+    Variable<P> p;
+
+    // Lambert W: x exp(x) = p, scanned over p in [0.1,100]
+    Function lambert = x * exp(x) - p;
+    // intersection of the circle x^2 + y^2 = p with the curve y = exp(-x), scanned over p in [1,50]
+    Function circle = x * x + y * y - p;
+    Function curve = y - exp(-x);
+
+    std::vector<double> ps(problems), ps2(problems);
+    for (std::size_t i = 0; i < problems; ++i)
+    {
+        ps[i] = 0.1 + 99.9 * static_cast<double>(i) / static_cast<double>(problems);
+        ps2[i] = 1. + 49. * static_cast<double>(i) / static_cast<double>(problems);
+    }
+    const auto lambertStart = [&]{std::vector<double> xs(problems); for (std::size_t i = 0; i < problems; ++i) {xs[i] = std::log1p(ps[i]);} return xs;};
+    const auto lambertResidual = [&](const std::vector<double> &xs)
+    {
+        double worst = 0;
+        for (std::size_t i = 0; i < problems; ++i)
+        {
+            const double resid = std::abs(xs[i] * std::exp(xs[i]) - ps[i]) / ps[i];
+            worst = std::isnan(resid) ? resid : std::max(worst,resid);
+        }
+        return worst;
+    };
+
+    std::cout << std::setw(30) << "system" << std::setw(9) << "threads" << std::setw(11) << "problems" << std::setw(11) << "converged"
+        << std::setw(13) << "Msolves/s" << std::setw(12) << "time [s]" << std::setw(13) << "max. resid." << "\n";
+
+    // baseline: one scalar solve per call, with the derivative evaluated by d()
+    const auto dlambert = d(lambert,diff_wrt(x));
+    std::vector<double> xs = lambertStart();
+    bool passed = true;
+    passed &= report("Lambert W (scalar loop)",1,problems,[&]
+    {
+        std::size_t converged = 0;
+        for (std::size_t i = 0; i < problems; ++i)
+        {
+            for (std::size_t it = 0; it < 50; ++it)
+            {
+                const double dx = lambert(X{xs[i]},P{ps[i]}) / dlambert(X{xs[i]},P{ps[i]});
+                xs[i] -= dx;
+                if (std::abs(dx) <= 1e-14 + 1e-12 * std::abs(xs[i])) {++converged; break;}
+            }
+        }
+        return converged;
+    },[&]{return lambertResidual(xs);});
+
+    Newton lambertSolver(lambert);
+    Newton circleSolver(circle,curve);
+    for (std::size_t threads = 1; threads <= maxThreads; threads *= 2)
+    {
+        ThreadPool pool(threads);
+
+        xs = lambertStart();
+        passed &= report("Lambert W (batched)",threads,problems,[&]
+        {
+            return lambertSolver.Solve(std::tuple(Unknown(x,xs)),std::tuple(Parameter(p,ps)),{},pool).converged;
+        },[&]{return lambertResidual(xs);});
+
+        std::vector<double> cx(problems), cy(problems,0.);
+        for (std::size_t i = 0; i < problems; ++i) {cx[i] = std::sqrt(ps2[i]);}
+        passed &= report("circle & exp curve (batched)",threads,problems,[&]
+        {
+            return circleSolver.Solve(std::tuple(Unknown(x,cx),Unknown(y,cy)),std::tuple(Parameter(p,ps2)),{},pool).converged;
+        },[&]
+        {
+            double worst = 0;
+            for (std::size_t i = 0; i < problems; ++i)
+            {
+                const double resid = std::max(std::abs(cx[i] * cx[i] + cy[i] * cy[i] - ps2[i]) / ps2[i],std::abs(cy[i] - std::exp(-cx[i])));
+                worst = std::isnan(resid) ? resid : std::max(worst,resid);
+            }
+            return worst;
+        });
+    }
+
+    std::cout << (passed ? "PASSED" : "FAILED") << "\n";
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,137 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <optional>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "Schroedinger.hxx"
+
+struct R {double r; constexpr double operator()() {return r;}};
+
+// exact levels of the 3D harmonic oscillator with the given l: hbar omega (2 n + l + 3 / 2)
+void report(std::string_view name, double seconds, const std::vector<femto::EigenState> &states, double hbarOmega, unsigned l, std::size_t firstNode = 0)
+{
+    std::cout << name << ": " << states.size() << " states in " << seconds << " s\n";
+    for (std::size_t i = 0; i < states.size(); ++i)
+    {
+        const double exact = hbarOmega * (2. * static_cast<double>(firstNode + i) + l + 1.5);
+        std::cout << std::setw(8) << firstNode + i << std::setw(22) << std::setprecision(14) << states[i].energy << std::setw(14) << std::setprecision(3) << states[i].energy - exact << "\n";
+    }
+}
+
+// Lanczos(count) has to return all the count lowest finite-difference states: the i-th of them with exactly i eigenvalues below it according to Count,
+// and close to the i-th Numerov level, which differs only by the discretisation error. The finite differences lower the energy of a wave with the kinetic energy T
+// by about T^2 step^2 / (12 hbar^2 / (2 mass)), which bounds the difference for T = E - minimum of the potential, as long as the step resolves the wave.
+template <typename F>
+bool check(std::string_view name, const F &potential, double minimum, std::size_t points, double mass, unsigned l, std::size_t count)
+{
+    using namespace femto;
+    const Schroedinger solver(potential,Variable<R>{},0.,20.,points,mass,l);
+    const double scale = constants::hbarcMeVfm() * constants::hbarcMeVfm() / (2. * mass);
+
+    std::vector<EigenState> lanczos, shot;
+    bool passed = true;
+    try
+    {
+        lanczos = solver.Lanczos(count,{.wavefunctions = false});
+        shot = solver.Shooting(count,{.wavefunctions = false});
+    }
+    catch (const std::exception &error)
+    {
+        std::cout << "  " << error.what() << "\n";
+        passed = false;
+    }
+    passed &= lanczos.size() == count && shot.size() == count;
+
+    double worst = 0;
+    std::size_t compared = 0;
+    for (std::size_t i = 0; i < std::min(lanczos.size(),shot.size()); ++i)
+    {
+        // the eigenvalues are resolved up to the rounding of the finite-difference Hamiltonian, whose norm is 4 / step^2
+        const double energy = lanczos[i].energy, margin = 1e-9 * std::abs(energy) + 10. * std::numeric_limits<double>::epsilon() * 4. * scale / (solver.Step() * solver.Step());
+        passed &= solver.Count(energy - margin) == i && solver.Count(energy + margin) == i + 1;
+
+        const double kinetic = energy - minimum;
+        if (std::sqrt(kinetic / scale) * solver.Step() > 0.5) {continue;} // fewer than 12 points per wavelength
+        const double bound = 2. * kinetic * kinetic * solver.Step() * solver.Step() / (12. * scale) + margin;
+        passed &= std::abs(energy - shot[i].energy) <= bound;
+        worst = std::max(worst,std::abs(energy - shot[i].energy) / bound);
+        ++compared;
+    }
+    std::cout << std::setw(30) << name << std::setw(4) << l << std::setw(9) << points << std::setw(5) << count << std::setw(7) << lanczos.size()
+        << std::setw(10) << compared << std::setw(14) << std::setprecision(3) << worst << std::setw(8) << (passed ? "ok" : "FAILED") << "\n";
+    return passed;
+}
+
+template <typename F>
+double seconds(F &&func)
+{
+    const auto start = std::chrono::steady_clock::now();
+    func();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// usage: bench_schroedinger [grid points] [threads]
+int main(int argc, char **argv)
+{
+    using namespace femto;
+    const std::size_t points = (argc > 1) ? std::strtoul(argv[1],nullptr,10) : 1'000'000;
+    const std::size_t threads = (argc > 2) ? std::strtoul(argv[2],nullptr,10) : std::max(std::thread::hardware_concurrency(),1u);
+    ThreadPool pool(threads);
+
+    // the spectrum of small and large grids, including the coarse ones where the lowest levels are resolved by only a few points
+    Variable<R> r;
+    const double mass = constants::protonMassMeV() / 2., hbarOmega = 10.;
+    Function oscillator = Constant(0.5) * r * r;
+    Function woodsSaxon = Constant(-50.) / (Constant(1.) + exp((r - Constant(4.)) / Constant(0.65)));
+    std::cout << std::setw(30) << "potential" << std::setw(4) << "l" << std::setw(9) << "points" << std::setw(5) << "k" << std::setw(7) << "found"
+        << std::setw(10) << "compared" << std::setw(14) << "diff./bound" << "\n";
+    bool passed = true;
+    for (const unsigned l : {0u,1u})
+    {
+        for (const auto &[n,count] : {std::pair<std::size_t,std::size_t>(10,3),{80,5},{100,10},{300,20},{1000,40},{10000,40},{100000,40},{100000,5}})
+        {
+            passed &= check("0.5 r^2",oscillator,0.,n,mass,l,count);
+            passed &= check("Woods-Saxon",woodsSaxon,-50.,n,mass,l,count);
+        }
+    }
+    std::cout << "\n";
+
+    // harmonic oscillator with hbar omega = 10 MeV for the reduced mass of two nucleons
+    const double k = mass * hbarOmega * hbarOmega / (constants::hbarcMeVfm() * constants::hbarcMeVfm());
+    Function potential = Constant(0.5 * k) * r * r;
+
+    std::cout << points << " grid points, " << threads << " threads; columns: state, energy [MeV], difference to the exact level [MeV]\n";
+    for (unsigned l : {0u,1u})
+    {
+        std::optional<Schroedinger<R> > solver;
+        const double setup = seconds([&]{solver.emplace(potential,r,0.,20.,points,mass,l,pool);});
+        std::cout << "\nl = " << l << ", potential tabulated in " << setup << " s\n";
+
+        std::vector<EigenState> states;
+        report("Numerov shooting, lowest 5",seconds([&]{states = solver->Shooting(5,{},pool);}),states,hbarOmega,l);
+        report("finite differences + Lanczos, lowest 5",seconds([&]{states = solver->Lanczos(5);}),states,hbarOmega,l);
+
+        // three windows of two levels each, in parallel
+        const std::vector<EnergyWindow> windows{{10.,50.},{50.,90.},{90.,130.}};
+        std::vector<std::vector<EigenState> > shot, lanczos;
+        const double shootingTime = seconds([&]{shot = solver->Shooting(windows,{},pool);});
+        const double lanczosTime = seconds([&]{lanczos = solver->Lanczos(windows,{},pool);});
+        for (std::size_t w = 0; w < windows.size(); ++w)
+        {
+            const std::size_t first = (windows[w].min < hbarOmega * (l + 1.5)) ? 0 : static_cast<std::size_t>((windows[w].min / hbarOmega - l - 1.5) / 2.) + 1;
+            report("  window " + std::to_string(w) + ", Numerov shooting",shootingTime,shot[w],hbarOmega,l,first);
+            report("  window " + std::to_string(w) + ", finite differences + Lanczos",lanczosTime,lanczos[w],hbarOmega,l,first);
+        }
+    }
+
+    std::cout << (passed ? "PASSED" : "FAILED") << "\n";
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,117 @@
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <string_view>
+#include <utility>
+#include "Cost.hxx"
+
+struct X
+{
+    double x;
+    constexpr double operator()() const {return x;}
+};
+
+struct Y
+{
+    double y;
+    constexpr double operator()() const {return y;}
+};
+
+// difference of value from the reference, relative for references larger than 1, NaN if either is NaN
+double rel_error(double value, double reference)
+{
+    return std::abs(value - reference) / std::max(1.,std::abs(reference));
+}
+
+inline constexpr std::pair<double,double> points[] = {{0.5,1.5},{1.,2.},{2.5,0.75},{-1.25,3.}};
+
+// simplify(func) has to evaluate to the same value as func
+template <typename F>
+bool check_simplify(std::string_view name, const F &func)
+{
+    using namespace femto;
+    const auto simplified = simplify(func);
+    double err = 0;
+    bool passed = true;
+    for (const auto &[valx,valy] : points)
+    {
+        const double e = rel_error(simplified(X{valx},Y{valy}),func(X{valx},Y{valy}));
+        err = std::isnan(e) ? e : std::max(err,e);
+        passed &= e <= 1e-14;
+    }
+    std::cout << std::setw(34) << name << std::setw(14) << "simplify" << std::setw(8) << node_count<F> << std::setw(8) << node_count<decltype(simplified)>
+        << std::setw(14) << err << std::setw(8) << (passed ? "ok" : "FAILED") << "\n";
+    return passed;
+}
+
+// the folded and shared derivatives d/dx, d2/dx2 and d2/dxdy against central finite differences of func, and against their expanded trees evaluated without sharing
+template <typename F>
+bool check_derivatives(std::string_view name, const F &func)
+{
+    using namespace femto;
+    Variable<X> x;
+    Variable<Y> y;
+    const auto dx = d(func,diff_wrt(x));
+    const auto dxx = d(dx,diff_wrt(x));
+    const auto dxy = d(dx,diff_wrt(y));
+    auto f = [&](double valx, double valy) {return func(X{valx},Y{valy});};
+
+    double errDx = 0, errDxx = 0, errDxy = 0;
+    bool passed = true;
+    for (const auto &[valx,valy] : points)
+    {
+        const double h = 1e-5 * std::max(1.,std::abs(valx));
+        const double k = 1e-4 * std::max(1.,std::abs(valy));
+        const double fdx = (f(valx + h,valy) - f(valx - h,valy)) / (2 * h);
+        const double fdxx = (f(valx + 10 * h,valy) - 2 * f(valx,valy) + f(valx - 10 * h,valy)) / (100 * h * h);
+        const double fdxy = (f(valx + h,valy + k) - f(valx + h,valy - k) - f(valx - h,valy + k) + f(valx - h,valy - k)) / (4 * h * k);
+
+        const double eDx = rel_error(dx(X{valx},Y{valy}),fdx);
+        const double eDxx = rel_error(dxx(X{valx},Y{valy}),fdxx);
+        const double eDxy = rel_error(dxy(X{valx},Y{valy}),fdxy);
+        errDx = std::isnan(eDx) ? eDx : std::max(errDx,eDx);
+        errDxx = std::isnan(eDxx) ? eDxx : std::max(errDxx,eDxx);
+        errDxy = std::isnan(eDxy) ? eDxy : std::max(errDxy,eDxy);
+        passed &= eDx <= 1e-8 && eDxx <= 1e-5 && eDxy <= 1e-6;
+
+        // the repeated subtrees are computed once, which may only change the rounding (the compiler contracts the two evaluations differently)
+        const double eShared = std::max({rel_error(dx(X{valx},Y{valy}),dx.Expand()(X{valx},Y{valy})),rel_error(dxx(X{valx},Y{valy}),dxx.Expand()(X{valx},Y{valy})),
+            rel_error(dxy(X{valx},Y{valy}),dxy.Expand()(X{valx},Y{valy}))});
+        passed &= eShared <= 1e-14;
+    }
+    std::cout << std::setw(34) << name << std::setw(14) << "d/dx" << std::setw(8) << node_count<F> << std::setw(8) << node_count<decltype(dx)> << std::setw(14) << errDx << "\n"
+        << std::setw(48) << "d2/dx2" << std::setw(8) << "" << std::setw(8) << node_count<decltype(dxx)> << std::setw(14) << errDxx << "\n"
+        << std::setw(48) << "d2/dxdy" << std::setw(8) << "" << std::setw(8) << node_count<decltype(dxy)> << std::setw(14) << errDxy << std::setw(8) << (passed ? "ok" : "FAILED") << "\n";
+    return passed;
+}
+
+int main()
+{
+    using namespace femto;
+    Variable<X> x;
+    Variable<Y> y;
+
+    std::cout << std::setprecision(3) << std::setw(34) << "function" << std::setw(14) << "check" << std::setw(8) << "nodes" << std::setw(8) << "result" << std::setw(14) << "rel. error" << "\n";
+
+    bool passed = true;
+    // the identities folded by simplify
+    passed &= check_simplify("0 * x + 1 * y",Literal<0>{} * x + Literal<1>{} * y);
+    passed &= check_simplify("x - x + y / 1 - 0 / x",x - x + y / Literal<1>{} - Literal<0>{} / x);
+    passed &= check_simplify("x^1 * y^0 + exp(0) - ln(1)",pow(x,Literal<1>{}) * pow(y,Literal<0>{}) + exp(Constant(0.)) - ln(Constant(1.)));
+    passed &= check_simplify("-(-x) + x + x",-(-x) + x + x);
+    passed &= check_simplify("2 * (3 * x) * (4 * y)",Constant(2.) * (Constant(3.) * x) * (Constant(4.) * y));
+    passed &= check_simplify("y * 2 + 2^3 - sqrt(4) / ln(e)",y * Constant(2.) + pow(Constant(2.),Constant(3)) - sqrt(Constant(4.)) / ln(Constant(std::exp(1.))));
+    passed &= check_simplify("(1 + 2) * x - (5 - 3) * exp(-0)",(Literal<1>{} + Literal<2>{}) * x - (Constant(5.) - Constant(3.)) * exp(-Constant(0.)));
+
+    // the derivatives, including subtrees of the same type which differ only in their constants
+    passed &= check_derivatives("-50 / (1 + exp((x - 4) / 0.65)) * y",Constant(-50.) / (Constant(1.) + exp((x - Constant(4.)) / Constant(0.65))) * y);
+    passed &= check_derivatives("x * y / (1 + x * x)",x * y / (Constant(1.) + x * x));
+    passed &= check_derivatives("exp(-x * y) * ln(x * x + y)",exp(-x * y) * ln(x * x + y));
+    passed &= check_derivatives("sqrt(x * x + y * y) * x^2.5 / y",sqrt(x * x + y * y) * pow(x * x,Constant(1.25)) / y);
+    passed &= check_derivatives("exp(1 * x * y) + exp(2 * x * y)",exp(Constant(1.) * x * y) + exp(Constant(2.) * x * y));
+    passed &= check_derivatives("(x + y)^3 / (x - 2 * y)",pow(x + y,Constant(3)) / (x - Constant(2.) * y));
+
+    std::cout << (passed ? "PASSED" : "FAILED") << "\n";
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,106 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "Benchmark.hxx"
+#include "Taylor.hxx"
+#include "bench_functions.hxx"
+
+// the two ways of differentiating round differently, the high derivatives of the Woods-Saxon potential lose about 1e-13 to cancellation
+inline constexpr double tolerance = 1e-12;
+
+// largest difference of the first derivatives relative to the reference values larger than 1, NaN if any of them is NaN
+template <std::size_t N, std::size_t M>
+double max_rel_diff(const std::vector<std::array<double,N> > &values, const std::vector<std::array<double,M> > &reference)
+{
+    double diff = 0;
+    for (std::size_t i = 0; i < values.size(); ++i)
+    {
+        for (std::size_t k = 0; k < std::min(N,M); ++k)
+        {
+            const double d = std::abs(values[i][k] - reference[i][k]) / std::max(1.,std::abs(reference[i][k]));
+            diff = std::isnan(d) ? d : std::max(diff,d);
+        }
+    }
+    return diff;
+}
+
+// time per point of f, f', ..., f^(4) from the nested derivatives and from a single pass on Jet<4>, and the largest relative difference between the two
+template <typename F>
+bool compare(std::string_view name, const F &func, const std::vector<double> &rs)
+{
+    using namespace femto;
+    const auto d1 = derivative<1>(func);
+    const auto d2 = derivative<2>(func);
+    const auto d3 = derivative<3>(func);
+    const auto d4 = derivative<4>(func);
+
+    std::vector<std::array<double,5> > nested(rs.size()), jets(rs.size());
+    const double nestedNs = bench::measure_ns([&]
+    {
+        for (std::size_t i = 0; i < rs.size(); ++i) {nested[i] = {func(R{rs[i]}),d1(R{rs[i]}),d2(R{rs[i]}),d3(R{rs[i]}),d4(R{rs[i]})};}
+        bench::do_not_optimise(nested);
+    });
+    const double jetNs = bench::measure_ns([&]
+    {
+        for (std::size_t i = 0; i < rs.size(); ++i) {jets[i] = derivatives<4>(func,r,R{rs[i]});}
+        bench::do_not_optimise(jets);
+    });
+
+    const double maxDiff = max_rel_diff(jets,nested);
+    const bool passed = maxDiff <= tolerance;
+    std::cout << std::setw(12) << name << std::setw(16) << nestedNs / rs.size() << std::setw(16) << jetNs / rs.size() << std::setw(10) << nestedNs / jetNs << std::setw(14) << maxDiff
+        << std::setw(8) << (passed ? "ok" : "FAILED") << "\n";
+    return passed;
+}
+
+// time per point of a single pass on Jet<N>, whose derivatives up to the 4th have to agree with the nested ones
+template <std::size_t N, typename F>
+bool jet_cost(const F &func, const std::vector<double> &rs, const std::vector<std::array<double,5> > &nested)
+{
+    std::vector<std::array<double,N + 1> > out(rs.size());
+    const double ns = femto::bench::measure_ns([&]
+    {
+        for (std::size_t i = 0; i < rs.size(); ++i) {out[i] = femto::derivatives<N>(func,r,R{rs[i]});}
+        femto::bench::do_not_optimise(out);
+    }) / rs.size();
+
+    const double maxDiff = max_rel_diff(out,nested);
+    const bool passed = maxDiff <= tolerance;
+    std::cout << std::setw(6) << N << std::setw(12) << ns << std::setw(14) << maxDiff << std::setw(8) << (passed ? "ok" : "FAILED") << "\n";
+    return passed;
+}
+
+int main()
+{
+    std::vector<double> rs(1 << 16);
+    for (std::size_t i = 0; i < rs.size(); ++i) {rs[i] = 0.1 + 10. * static_cast<double>(i) / static_cast<double>(rs.size());}
+
+    std::cout << "f and its first 4 derivatives, " << rs.size() << " points\n"
+        << std::setw(12) << "function" << std::setw(16) << "nested d() [ns]" << std::setw(16) << "Jet<4> [ns]" << std::setw(10) << "speedup" << std::setw(14) << "max rel diff" << "\n";
+    bool passed = true;
+    passed &= compare("Woods-Saxon",woodsSaxon,rs);
+    passed &= compare("Yukawa",yukawa,rs);
+    passed &= compare("Gaussian",gaussian,rs);
+    passed &= compare("power-log",powerLog,rs);
+
+    std::vector<std::array<double,5> > nested(rs.size());
+    const auto d1 = derivative<1>(woodsSaxon);
+    const auto d2 = derivative<2>(woodsSaxon);
+    const auto d3 = derivative<3>(woodsSaxon);
+    const auto d4 = derivative<4>(woodsSaxon);
+    for (std::size_t i = 0; i < rs.size(); ++i) {nested[i] = {woodsSaxon(R{rs[i]}),d1(R{rs[i]}),d2(R{rs[i]}),d3(R{rs[i]}),d4(R{rs[i]})};}
+
+    std::cout << "\ncost of one pass on Jet<N> for the Woods-Saxon potential\n" << std::setw(6) << "N" << std::setw(12) << "time [ns]" << std::setw(14) << "max rel diff" << "\n";
+    [&]<std::size_t ... Ns>(std::index_sequence<Ns...>)
+    {
+        ((passed &= jet_cost<Ns>(woodsSaxon,rs,nested)), ...);
+    }(std::index_sequence<0,1,2,4,8,16,32>{});
+
+    std::cout << (passed ? "PASSED" : "FAILED") << "\n";
+    return passed ? 0 : 1;
+}